@@ -166,6 +166,16 @@ public @interface Kroll
 		 * @module.api
 		 */
 		boolean runOnUiThread() default false;
+		/**
+		 * <p>When set to true, this method runs on a worker thread instead of the KrollRuntime thread, so slow
+		 * work (file or database I/O, bitmap decoding...) does not block JavaScript. The arguments are converted
+		 * before the call, and the method must not use JavaScript objects or call back into JavaScript synchronously.</p>
+		 * <p>JavaScript passes a callback function as the last argument. It is called on the KrollRuntime thread
+		 * with <code>{ success: true, code: 0, result: ... }</code>, or <code>{ success: false, code: -1, error: ... }</code>
+		 * when the method throws. The JavaScript call itself returns undefined.</p>
+		 * @module.api
+		 */
+		boolean async() default false;
 	}
 
 	/**
@@ -270,6 +280,7 @@ public @interface Kroll
 	 * 
 	 * @see getProperty#name()
 	 * @see getProperty#runOnUiThread()
+	 * @see getProperty#cache()
 	 * @see org.appcelerator.kroll.KrollInvocation
 	 * @see method @Kroll.method
 	 * @see argument#optional()
@@ -289,6 +300,14 @@ public @interface Kroll
 		 * When set to true, this property getter will only be executed on the UI thread.<br>
 		 */
 		boolean runOnUiThread() default false;
+		/**
+		 * When set to true, reads of this property are served from the proxy's JavaScript property map
+		 * without calling into Java. The getter is only invoked on the first read, its result is then cached.<br>
+		 * The proxy must push new values with {@link org.appcelerator.kroll.KrollProxy#setProperty(String, Object)}
+		 * whenever the value changes. Calling the property setter from JavaScript drops the cached value.
+		 * @module.api
+		 */
+		boolean cache() default false;
 	}
 
 	/**
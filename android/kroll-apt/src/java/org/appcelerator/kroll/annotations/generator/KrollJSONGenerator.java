@@ -440,6 +440,10 @@ public class KrollJSONGenerator extends AbstractProcessor {
 
 			methodAttrs.put("args", args);
 			methodAttrs.put("returnType", element.getReturnType().toString());
+
+			if (Boolean.TRUE.equals(methodAttrs.get("async")) && Boolean.TRUE.equals(methodAttrs.get("runOnUiThread"))) {
+				warn("Method %s is async, runOnUiThread is ignored", methodName);
+			}
 		}
 
 		protected void visitProperty(AnnotationMirror annotation, VariableElement element)
@@ -559,6 +563,7 @@ public class KrollJSONGenerator extends AbstractProcessor {
 
 			if (utils.annotationTypeIs(annotation, Kroll_getProperty)) {
 				dynamicProperty.put("get", true);
+				dynamicProperty.put("cache", params.get("cache"));
 				dynamicProperty.put("getMethodName", methodName);
 				dynamicProperty.put("getDefaultProviders", defaultProviders);
 				dynamicProperty.put("getMethodArgs", args);
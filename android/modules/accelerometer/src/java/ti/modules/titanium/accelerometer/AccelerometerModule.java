@@ -9,6 +9,7 @@ package ti.modules.titanium.accelerometer;
 import org.appcelerator.kroll.KrollDict;
 import org.appcelerator.kroll.KrollModule;
 import org.appcelerator.kroll.KrollProxy;
+import org.appcelerator.kroll.KrollRuntime;
 import org.appcelerator.kroll.annotations.Kroll;
 import org.appcelerator.titanium.TiContext;
 import org.appcelerator.titanium.util.TiSensorHelper;
@@ -38,6 +39,16 @@ public class AccelerometerModule extends KrollModule implements SensorEventListe
 		this();
 	}
 
+	@Override
+	public int getEventCoalescing(String event)
+	{
+		// Only the latest reading matters to a listener that falls behind.
+		if (EVENT_UPDATE.equals(event)) {
+			return KrollRuntime.EVENT_COALESCE_LATEST;
+		}
+		return super.getEventCoalescing(event);
+	}
+
 	@Override
 	public void eventListenerAdded(String type, int count, final KrollProxy proxy)
 	{
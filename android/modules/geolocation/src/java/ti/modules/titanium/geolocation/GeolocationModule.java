@@ -780,15 +780,13 @@ public class GeolocationModule extends KrollModule
 			Location latestKnownLocation = tiLocation.getLastKnownLocation();
 
 			if (latestKnownLocation != null) {
-				callback.call(this.getKrollObject(), new Object[] {
-					buildLocationEvent(latestKnownLocation, tiLocation.locationManager.getProvider(latestKnownLocation.getProvider()))
-				});
+				callback.call(this.getKrollObject(),
+					buildLocationEvent(latestKnownLocation, tiLocation.locationManager.getProvider(latestKnownLocation.getProvider())));
 
 			} else {
 				Log.e(TAG, "Unable to get current position, location is null");
-				callback.call(this.getKrollObject(), new Object[] {
-					buildLocationErrorEvent(TiLocation.ERR_POSITION_UNAVAILABLE, "location is currently unavailable.")
-				});
+				callback.call(this.getKrollObject(),
+					buildLocationErrorEvent(TiLocation.ERR_POSITION_UNAVAILABLE, "location is currently unavailable."));
 			}
 		}
 	}
@@ -839,7 +837,7 @@ public class GeolocationModule extends KrollModule
 			public void handleGeocodeResponse(KrollDict geocodeResponse)
 			{
 				geocodeResponse.put(TiC.EVENT_PROPERTY_SOURCE, geolocationModule);
-				callback.call(getKrollObject(), new Object[] { geocodeResponse });
+				callback.call(getKrollObject(), geocodeResponse);
 			}
 		};
 	}
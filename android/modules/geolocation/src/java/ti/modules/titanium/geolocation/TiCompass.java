@@ -91,7 +91,7 @@ public class TiCompass
 		}
 	}
 
-	private Object eventToHashMap(SensorEvent event, long timestamp)
+	private KrollDict eventToHashMap(SensorEvent event, long timestamp)
 	{
 		float x = event.values[0];
 		float y = event.values[1];
@@ -195,7 +195,7 @@ public class TiCompass
 						long eventTimestamp = event.timestamp / 1000000;
 						long actualTimestamp = baseTime.getTimeInMillis() + (eventTimestamp - sensorTimerStart);
 
-						listener.callAsync(geolocationModule.getKrollObject(), new Object[] { eventToHashMap(event, actualTimestamp) });
+						listener.callAsync(geolocationModule.getKrollObject(), eventToHashMap(event, actualTimestamp));
 						TiSensorHelper.unregisterListener(Sensor.TYPE_ORIENTATION, this);
 					}
 				}
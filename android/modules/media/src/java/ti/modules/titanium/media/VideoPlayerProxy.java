@@ -755,7 +755,7 @@ public class VideoPlayerProxy extends TiViewProxy implements TiLifecycle.OnLifec
 			public void handleThumbnailResponse(KrollDict bitmapResponse)
 			{
 				bitmapResponse.put(TiC.EVENT_PROPERTY_SOURCE, videoPlayerProxy);
-				callback.call(getKrollObject(), new Object[] { bitmapResponse });
+				callback.call(getKrollObject(), bitmapResponse);
 			}
 		};
 	}
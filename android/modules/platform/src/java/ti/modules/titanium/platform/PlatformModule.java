@@ -62,7 +62,7 @@ public class PlatformModule extends KrollModule
 		return TiPlatformHelper.getInstance().getName();
 	}
 
-	@Kroll.getProperty @Kroll.method
+	@Kroll.getProperty(cache=true) @Kroll.method
 	public String getOsname() {
 		return TiPlatformHelper.getInstance().getName();
 	}
@@ -72,7 +72,7 @@ public class PlatformModule extends KrollModule
 		return TiPlatformHelper.getInstance().getLocale();
 	}
 
-	@Kroll.getProperty @Kroll.method
+	@Kroll.getProperty(cache=true) @Kroll.method
 	public DisplayCapsProxy getDisplayCaps() {
 		if (displayCaps == null) {
 			displayCaps = new DisplayCapsProxy();
@@ -81,7 +81,7 @@ public class PlatformModule extends KrollModule
 		return displayCaps;
 	}
 
-	@Kroll.getProperty @Kroll.method
+	@Kroll.getProperty(cache=true) @Kroll.method
 	public int getProcessorCount() {
 		return TiPlatformHelper.getInstance().getProcessorCount();
 	}
@@ -101,22 +101,22 @@ public class PlatformModule extends KrollModule
 		return TiPlatformHelper.getInstance().getAvailableMemory();
 	}
 
-	@Kroll.getProperty @Kroll.method
+	@Kroll.getProperty(cache=true) @Kroll.method
 	public String getModel() {
 		return TiPlatformHelper.getInstance().getModel();
 	}
 
-	@Kroll.getProperty @Kroll.method
+	@Kroll.getProperty(cache=true) @Kroll.method
 	public String getManufacturer() {
 		return TiPlatformHelper.getInstance().getManufacturer();
 	}
 
-	@Kroll.getProperty @Kroll.method
+	@Kroll.getProperty(cache=true) @Kroll.method
 	public String getOstype() {
 		return TiPlatformHelper.getInstance().getOstype();
 	}
 
-	@Kroll.getProperty @Kroll.method
+	@Kroll.getProperty(cache=true) @Kroll.method
 	public String getArchitecture() {
 		return TiPlatformHelper.getInstance().getArchitecture();
 	}
@@ -21,6 +21,12 @@ public interface KrollApplication
 
 	public int getThreadStackSize();
 
+	public int getMaxYoungSpaceSize();
+
+	public int getMaxOldSpaceSize();
+
+	public boolean isProfilingEnabled();
+
 	public Activity getCurrentActivity();
 
 	public void waitForCurrentActivity(CurrentActivityListener l);
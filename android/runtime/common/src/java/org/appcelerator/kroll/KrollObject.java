@@ -6,7 +6,9 @@
  */
 package org.appcelerator.kroll;
 
+import java.nio.ByteBuffer;
 import java.util.HashMap;
+import java.util.concurrent.ConcurrentHashMap;
 
 import org.appcelerator.kroll.common.AsyncResult;
 import org.appcelerator.kroll.common.TiMessenger;
@@ -22,11 +24,22 @@ public abstract class KrollObject implements Handler.Callback
 
 	protected static final int MSG_RELEASE = 100;
 	protected static final int MSG_SET_WINDOW = 101;
-	protected static final int MSG_LAST_ID = MSG_SET_WINDOW;
+	protected static final int MSG_SET_EXTERNAL_ARRAY_DATA = 102;
+	protected static final int MSG_ADJUST_EXTERNAL_MEMORY = 103;
+	protected static final int MSG_SET_BUBBLE_PARENT = 104;
+	protected static final int MSG_LAST_ID = MSG_SET_BUBBLE_PARENT;
+
+	// Event types are interned to small ids shared with the native runtime.
+	// Listeners for the first LISTENER_BITMAP_BITS types are tracked in a bitmap
+	// the runtime updates directly, the others in hasListenersForEventType.
+	public static final int LISTENER_BITMAP_BITS = 128;
+	private static final ConcurrentHashMap<String, Integer> eventTypeIds = new ConcurrentHashMap<String, Integer>();
 
 	protected HashMap<String, Boolean> hasListenersForEventType = new HashMap<String, Boolean>();
 	protected Handler handler;
 
+	private volatile ByteBuffer listenerBitmap;
+
 	private KrollProxySupport proxySupport;
 
 	public KrollObject()
@@ -50,6 +63,17 @@ public abstract class KrollObject implements Handler.Callback
 	 */
 	public boolean hasListeners(String event)
 	{
+		Integer id = eventTypeIds.get(event);
+		if (id == null) {
+			// Types get an id before their first listener is registered.
+			return false;
+		}
+
+		if (id < LISTENER_BITMAP_BITS) {
+			ByteBuffer bitmap = listenerBitmap;
+			return bitmap != null && (bitmap.get(id >> 3) & (1 << (id & 7))) != 0;
+		}
+
 		Boolean hasListeners = hasListenersForEventType.get(event);
 		if (hasListeners == null) {
 			return false;
@@ -58,6 +82,42 @@ public abstract class KrollObject implements Handler.Callback
 		return hasListeners.booleanValue();
 	}
 
+	/**
+	 * Returns the id of an event type, assigning a new one the first time the type is seen.
+	 * The ids are shared with the native runtime.
+	 * @param event the event type.
+	 * @return the id of the event type.
+	 */
+	public static int getEventTypeId(String event)
+	{
+		Integer id = eventTypeIds.get(event);
+		if (id != null) {
+			return id;
+		}
+
+		synchronized (eventTypeIds) {
+			id = eventTypeIds.get(event);
+			if (id == null) {
+				id = eventTypeIds.size();
+				eventTypeIds.put(event, id);
+			}
+			return id;
+		}
+	}
+
+	/**
+	 * Returns the bitmap of the event type ids this object has listeners for. The runtime
+	 * sets and clears the bits directly as listeners are added and removed.
+	 * @return a direct buffer of LISTENER_BITMAP_BITS bits.
+	 */
+	public synchronized ByteBuffer getListenerBitmap()
+	{
+		if (listenerBitmap == null) {
+			listenerBitmap = ByteBuffer.allocateDirect(LISTENER_BITMAP_BITS / 8);
+		}
+		return listenerBitmap;
+	}
+
 	/**
 	 * Sets whether the passed in event has a corresponding eventListener associated with it on JS side.
 	 * @param event  the event to be set.
@@ -65,7 +125,16 @@ public abstract class KrollObject implements Handler.Callback
 	 */
 	public void setHasListenersForEventType(String event, boolean hasListeners)
 	{
-		hasListenersForEventType.put(event, hasListeners);
+		int id = getEventTypeId(event);
+		if (id < LISTENER_BITMAP_BITS) {
+			ByteBuffer bitmap = getListenerBitmap();
+			int bits = bitmap.get(id >> 3);
+			bits = hasListeners ? (bits | (1 << (id & 7))) : (bits & ~(1 << (id & 7)));
+			bitmap.put(id >> 3, (byte) bits);
+		} else {
+			hasListenersForEventType.put(event, hasListeners);
+		}
+
 		if (proxySupport != null) {
 			proxySupport.onHasListenersChanged(event, hasListeners);
 		}
@@ -133,6 +202,63 @@ public abstract class KrollObject implements Handler.Callback
 		}
 	}
 
+	/**
+	 * Backs the indexed properties of the JavaScript object with the memory of a direct buffer.
+	 * Indexed reads and writes from JavaScript then access the buffer without calling into Java.
+	 * The caller must keep the buffer alive for as long as the JavaScript object may use it.
+	 * @param data a direct ByteBuffer, each byte is exposed as an unsigned index.
+	 */
+	public void setExternalArrayData(ByteBuffer data)
+	{
+		if (KrollRuntime.getInstance().isRuntimeThread()) {
+			doSetExternalArrayData(data);
+
+		} else {
+			TiMessenger.sendBlockingRuntimeMessage(handler.obtainMessage(MSG_SET_EXTERNAL_ARRAY_DATA), data);
+		}
+	}
+
+	/**
+	 * Reports memory held by this object outside of the Java and JavaScript heaps
+	 * (ex: bitmaps, direct buffers) so the JavaScript engine accounts for it when
+	 * scheduling garbage collections. The memory is no longer reported once
+	 * the JavaScript object becomes unreachable.
+	 * @param bytes the number of bytes acquired, or a negative number of bytes released.
+	 */
+	public void adjustExternalMemory(long bytes)
+	{
+		if (bytes == 0) {
+			return;
+		}
+
+		if (KrollRuntime.getInstance().isRuntimeThread()) {
+			doAdjustExternalMemory(bytes);
+
+		} else {
+			// Accounting does not need to block the caller.
+			Message message = handler.obtainMessage(MSG_ADJUST_EXTERNAL_MEMORY, Long.valueOf(bytes));
+			message.sendToTarget();
+		}
+	}
+
+	/**
+	 * Mirrors the object events bubble to into the JavaScript object, so bubbled
+	 * events walk up to the parent without going through Java.
+	 * @param parent the parent to bubble events to, or null to stop bubbling.
+	 * @param linked false if the parent is not known to the JavaScript side, in which
+	 * case events bubble through the proxy's fireEventToParent().
+	 */
+	public void setBubbleParent(KrollObject parent, boolean linked)
+	{
+		if (KrollRuntime.getInstance().isRuntimeThread()) {
+			doSetBubbleParent(parent, linked);
+
+		} else {
+			Message message = handler.obtainMessage(MSG_SET_BUBBLE_PARENT, linked ? 1 : 0, 0, parent);
+			message.sendToTarget();
+		}
+	}
+
 	public boolean handleMessage(Message msg)
 	{
 		switch (msg.what) {
@@ -146,6 +272,23 @@ public abstract class KrollObject implements Handler.Callback
 				doSetWindow(result.getArg());
 				result.setResult(null);
 
+				return true;
+			}
+			case MSG_SET_EXTERNAL_ARRAY_DATA: {
+				AsyncResult result = (AsyncResult) msg.obj;
+				doSetExternalArrayData((ByteBuffer) result.getArg());
+				result.setResult(null);
+
+				return true;
+			}
+			case MSG_ADJUST_EXTERNAL_MEMORY: {
+				doAdjustExternalMemory(((Long) msg.obj).longValue());
+
+				return true;
+			}
+			case MSG_SET_BUBBLE_PARENT: {
+				doSetBubbleParent((KrollObject) msg.obj, msg.arg1 != 0);
+
 				return true;
 			}
 		}
@@ -158,5 +301,8 @@ public abstract class KrollObject implements Handler.Callback
 	protected abstract boolean fireEvent(KrollObject source, String type, Object data, boolean bubbles, boolean reportSuccess, int code, String message);
 	protected abstract void doRelease();
 	protected abstract void doSetWindow(Object windowProxyObject);
+	protected abstract void doSetExternalArrayData(ByteBuffer data);
+	protected abstract void doAdjustExternalMemory(long bytes);
+	protected abstract void doSetBubbleParent(KrollObject parent, boolean linked);
 }
 
@@ -39,6 +39,7 @@ public abstract class KrollRuntime implements Handler.Callback
 	private static final int MSG_DISPOSE = 101;
 	private static final int MSG_RUN_MODULE = 102;
 	private static final int MSG_EVAL_STRING = 103;
+	private static final int MSG_LOW_MEMORY = 104;
 
 	private static final String PROPERTY_FILENAME = "filename";
 	private static final String PROPERTY_SOURCE = "source";
@@ -71,6 +72,13 @@ public abstract class KrollRuntime implements Handler.Callback
 		}
 	};
 
+	/** Every pending event is dispatched. */
+	public static final int EVENT_COALESCE_NONE = 0;
+	/** Only the latest pending event of a proxy and event type is dispatched. */
+	public static final int EVENT_COALESCE_LATEST = 1;
+	/** The latest pending event carries the data of the earlier ones in its "history" array. */
+	public static final int EVENT_COALESCE_ACCUMULATE = 2;
+
 	public static final int DONT_INTERCEPT = Integer.MIN_VALUE + 1;
 	public static final int DEFAULT_THREAD_STACK_SIZE = 16 * 1024;
 	public static final String SOURCE_ANONYMOUS = "<anonymous>";
@@ -161,6 +169,17 @@ public abstract class KrollRuntime implements Handler.Callback
 		}
 	}
 
+	/**
+	 * Asks the runtime to release as much memory as it can.
+	 * @param level the Android trim memory level, ex: ComponentCallbacks2.TRIM_MEMORY_COMPLETE.
+	 */
+	public static void notifyLowMemory(int level)
+	{
+		if (isInitialized()) {
+			instance.handler.obtainMessage(MSG_LOW_MEMORY, level, 0).sendToTarget();
+		}
+	}
+
 	public static boolean isInitialized()
 	{
 		if (instance != null) {
@@ -327,6 +346,11 @@ public abstract class KrollRuntime implements Handler.Callback
 				doEvalString(source, filename);
 				return true;
 			}
+
+			case MSG_LOW_MEMORY: {
+				doLowMemory(msg.arg1);
+				return true;
+			}
 		}
 
 		return false;
@@ -475,6 +499,28 @@ public abstract class KrollRuntime implements Handler.Callback
 		// No-op V8 should override.
 	}
 
+	public void doLowMemory(int level)
+	{
+		// No-op V8 should override.
+	}
+
+	/**
+	 * Posts an event fired asynchronously by a proxy to the runtime's event queue.
+	 * Can be called from any thread. Queued events are dispatched in batches, so an event
+	 * may be dispatched before runtime Handler messages sent after it, such as property
+	 * updates or synchronous events.
+	 * @param proxy the proxy firing the event.
+	 * @param event the event type.
+	 * @param data the event data.
+	 * @param coalescing how pending events of this type are coalesced, one of the EVENT_COALESCE_* constants.
+	 * @return false if the runtime has no event queue, the caller then sends the event itself.
+	 */
+	public boolean postEvent(KrollProxySupport proxy, String event, Object data, int coalescing)
+	{
+		// V8 should override.
+		return false;
+	}
+
 	public State getRuntimeState()
 	{
 		return runtimeState;
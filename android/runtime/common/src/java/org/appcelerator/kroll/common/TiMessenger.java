@@ -373,6 +373,25 @@ public class TiMessenger implements Handler.Callback
 		return blockingMessageCount.get() > 0;
 	}
 
+	/**
+	 * Marks the current thread as blocked on another thread, without sending a blocking message.
+	 * Until {@link #endBlocking()}, messages sent to this thread are queued and the caller
+	 * dispatches them with {@link #dispatchPendingMessages()} while it waits.
+	 */
+	public void beginBlocking()
+	{
+		blockingMessageCount.incrementAndGet();
+	}
+
+	/**
+	 * Ends a wait started by {@link #beginBlocking()} and dispatches the messages still queued.
+	 */
+	public void endBlocking()
+	{
+		blockingMessageCount.decrementAndGet();
+		dispatchPendingMessages();
+	}
+
 	public void dispatchPendingMessages()
 	{
 		while (true) {
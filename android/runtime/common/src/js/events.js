@@ -29,93 +29,9 @@ var isArray = Array.isArray;
 //10 listeners are added to it. This is a useful default which
 //helps finding memory leaks.
 
-Object.defineProperty(EventEmitter.prototype, "callHandler", {
-	value: function(handler, type, data) {
-		//kroll.log(TAG, "calling event handler: type:" + type + ", data: " + data + ", handler: " + handler);
-
-		var handled = false,
-			cancelBubble = data.cancelBubble,
-			event;
-
-		if (handler.listener && handler.listener.call) {
-			// Create event object, copy any custom event data, and set the "type" and "source" properties.
-			event = { type: type, source: this };
-			kroll.extend(event, data);
-
-			if (handler.self && (event.source == handler.self.view)) {
-				event.source = handler.self;
-			}
-
-			handler.listener.call(this, event);
-
-			// The "cancelBubble" property may be reset in the handler.
-			if (event.cancelBubble !== cancelBubble) {
-				cancelBubble = event.cancelBubble;
-			}
-
-			handled = true;
-
-		} else if (kroll.DBG) {
-			kroll.log(TAG, "handler for event '" + type + "' is " + (typeof handler.listener) + " and cannot be called.");
-		}
-
-		// Bubble the events to the parent view if needed.
-		if (data.bubbles && !cancelBubble) {
-			handled = this._fireEventToParent(type, data) || handled;
-		}
-
-		return handled;
-	},
-	enumerable: false
-});
-
-Object.defineProperty(EventEmitter.prototype, "emit", {
-	value: function(type) {
-		var handled = false,
-			data = arguments[1],
-			handler,
-			listeners;
-
-		// Set the "bubbles" and "cancelBubble" properties for event data.
-		if (data !== null && typeof data == "object") {
-			data.bubbles = !!data.bubbles;
-			data.cancelBubble = !!data.cancelBubble;
-
-		} else {
-			data = { bubbles: false, cancelBubble: false };
-		}
-
-		if (this._hasJavaListener) {
-			this._onEventFired( type,  data );
-		}
-
-		if (!this._events || !this._events[type] || !this.callHandler) {
-			if (data.bubbles && !data.cancelBubble) {
-				handled = this._fireEventToParent(type, data);
-			}
-			return handled;
-		}
-
-		handler = this._events[type];
-		if (typeof handler.listener == 'function') {
-			handled = this.callHandler(handler, type, data);
-
-		} else if (isArray(handler)) {
-			listeners = handler.slice();
-			for (var i = 0, l = listeners.length; i < l; i++) {
-				handled = this.callHandler(listeners[i], type, data) || handled;
-			}
-
-		} else {
-			if (data.bubbles && !data.cancelBubble) {
-				handled = this._fireEventToParent(type, data);
-			}
-		}
-
-		return handled;
-	},
-	enumerable: false
-});
+// EventEmitter.prototype.emit() is implemented natively in EventEmitter.cpp.
+// It reads the listeners from "_events" without copying them, so the
+// listener arrays below are replaced instead of modified in place.
 
 // Titanium compatibility
 Object.defineProperty(EventEmitter.prototype, "fireEvent", {
@@ -129,7 +45,7 @@ Object.defineProperty(EventEmitter.prototype, "fireSyncEvent", {
 	enumerable: false
 });
 
-//EventEmitter is defined in src/node_events.cc
+//EventEmitter is defined in EventEmitter.cpp
 //EventEmitter.prototype.emit() is also defined there.
 Object.defineProperty(EventEmitter.prototype, "addListener", {
 	value: function(type, listener, view) {
@@ -160,8 +76,8 @@ Object.defineProperty(EventEmitter.prototype, "addListener", {
 			// Optimize the case of one listener. Don't need the extra array object.
 			this._events[type] = listenerWrapper;
 		} else if (isArray(this._events[type])) {
-			// If we've already got an array, just append.
-			this._events[type].push(listenerWrapper);
+			// If we've already got an array, append to a copy of it.
+			this._events[type] = this._events[type].concat([listenerWrapper]);
 		} else {
 			// Adding the second element, need to change to array.
 			this._events[type] = [this._events[type], listenerWrapper];
@@ -248,8 +164,11 @@ Object.defineProperty(EventEmitter.prototype, "removeListener", {
 				return this;
 			}
 			
+			// Copy the list, it may be in the middle of being dispatched.
+			list = list.slice();
 			list.splice(position, 1);
-			
+			this._events[type] = list;
+
 			if (list.length == 0) {
 				delete this._events[type];
 			}
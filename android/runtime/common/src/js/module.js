@@ -26,6 +26,7 @@ function Module(id, parent, context) {
 	this.exited = false;
 	this.children = [];
 	this.wrapperCache = {};
+	this.disposable = false;
 }
 kroll.Module = module.exports = Module;
 
@@ -34,6 +35,22 @@ Module.main = null;
 Module.paths = [ 'Resources/' ];
 Module.wrap = NativeModule.wrap;
 
+// Removes the modules that set "module.disposable = true" from
+// the cache so their exports can be collected when the app is low on
+// memory. They are evaluated again the next time they are required.
+// Returns the number of modules removed.
+Module.trimCache = function () {
+	var trimmed = 0;
+	for (var filename in Module.cache) {
+		var cachedModule = Module.cache[filename];
+		if (cachedModule && cachedModule.disposable && cachedModule.loaded) {
+			delete Module.cache[filename];
+			trimmed++;
+		}
+	}
+	return trimmed;
+};
+
 Module.runModule = function (source, filename, activityOrService) {
 	var id = filename;
 	if (!Module.main) {
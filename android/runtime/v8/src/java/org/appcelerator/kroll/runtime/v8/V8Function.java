@@ -7,6 +7,7 @@
 package org.appcelerator.kroll.runtime.v8;
 
 import java.util.HashMap;
+import java.util.concurrent.ConcurrentLinkedQueue;
 
 import org.appcelerator.kroll.KrollFunction;
 import org.appcelerator.kroll.KrollObject;
@@ -26,6 +27,24 @@ public class V8Function extends V8Object implements KrollFunction, Handler.Callb
 	protected static final int MSG_CALL_SYNC = V8Object.MSG_LAST_ID + 100;
 	protected static final int MSG_LAST_ID = MSG_CALL_SYNC;
 
+	// Asynchronous calls which did not fit in the native call queue. Once a call overflowed, later
+	// calls follow it here until the runtime thread caught up, so callbacks keep their order.
+	private static final ConcurrentLinkedQueue<OverflowCall> overflowCalls = new ConcurrentLinkedQueue<OverflowCall>();
+
+	private static class OverflowCall
+	{
+		final V8Function function;
+		final KrollObject krollObject;
+		final Object[] args;
+
+		OverflowCall(V8Function function, KrollObject krollObject, Object[] args)
+		{
+			this.function = function;
+			this.krollObject = krollObject;
+			this.args = args;
+		}
+	}
+
 	public V8Function(long pointer)
 	{
 		super(pointer);
@@ -33,9 +52,20 @@ public class V8Function extends V8Object implements KrollFunction, Handler.Callb
 
 	public Object call(KrollObject krollObject, HashMap args)
 	{
+		if (canInvokeDirectly()) {
+			return nativeInvokeMap(((V8Object) krollObject).getPointer(), getPointer(), args);
+		}
 		return call(krollObject, new Object[] { args });
 	}
 
+	// The map call passes its argument to native code without boxing it into an
+	// Object[]. It is made directly on the runtime thread only, other threads and a
+	// disposed runtime go through call(KrollObject, Object[]).
+	private boolean canInvokeDirectly()
+	{
+		return KrollRuntime.getInstance().isRuntimeThread() && KrollRuntime.isInitialized();
+	}
+
 	public Object call(KrollObject krollObject, Object[] args)
 	{
 		if (KrollRuntime.getInstance().isRuntimeThread())
@@ -43,8 +73,26 @@ public class V8Function extends V8Object implements KrollFunction, Handler.Callb
 			return callSync(krollObject, args);
 
 		} else {
-			return TiMessenger.sendBlockingRuntimeMessage(handler.obtainMessage(MSG_CALL_SYNC), new FunctionArgs(
-				krollObject, args));
+			long completion = KrollRuntime.isInitialized() ? nativeQueueBlockingCall(this, krollObject, args) : 0;
+			if (completion == 0) {
+				// the native queue is full
+				return TiMessenger.sendBlockingRuntimeMessage(handler.obtainMessage(MSG_CALL_SYNC), new FunctionArgs(
+					krollObject, args));
+			}
+			V8Runtime.scheduleBlockingCallDrain();
+
+			// Messages sent to this thread while it waits are dispatched, as
+			// the runtime thread may block on this thread during the call.
+			TiMessenger messenger = TiMessenger.getMessenger();
+			messenger.beginBlocking();
+			try {
+				while (!nativeAwaitCall(completion, TiMessenger.DEFAULT_TIMEOUT)) {
+					messenger.dispatchPendingMessages();
+				}
+			} finally {
+				messenger.endBlocking();
+			}
+			return nativeFinishCall(completion);
 		}
 	}
 
@@ -62,14 +110,28 @@ public class V8Function extends V8Object implements KrollFunction, Handler.Callb
 		callAsync(krollObject, new Object[] { args });
 	}
 
-	public void callAsync(final KrollObject krollObject, final Object[] args)
+	public void callAsync(KrollObject krollObject, Object[] args)
 	{
-		TiMessenger.postOnRuntime(new Runnable() {
-			public void run()
-			{
-				call(krollObject, args);
+		if (!overflowCalls.isEmpty() || !KrollRuntime.isInitialized() || !nativeQueueCall(this, krollObject, args)) {
+			overflowCalls.add(new OverflowCall(this, krollObject, args));
+		}
+		V8Runtime.scheduleAsyncCallDrain();
+	}
+
+	/**
+	 * Runs the asynchronous calls which overflowed the native call queue, after the calls queued
+	 * before them. Called on the runtime thread.
+	 */
+	static void drainOverflowCalls()
+	{
+		// Calls queued by the called functions wait for the next drain.
+		for (int count = overflowCalls.size(); count > 0; count--) {
+			OverflowCall call = overflowCalls.poll();
+			if (call == null) {
+				break;
 			}
-		});
+			call.function.callSync(call.krollObject, call.args);
+		}
 	}
 
 	@Override
@@ -88,6 +150,19 @@ public class V8Function extends V8Object implements KrollFunction, Handler.Callb
 		return super.handleMessage(message);
 	}
 
+	@Override
+	protected void release()
+	{
+		// Functions are not proxy wrappers, they skip the batched release of V8Object
+		// and free their persistent handle through doRelease() on the runtime thread.
+		if (KrollRuntime.getInstance().isRuntimeThread()) {
+			doRelease();
+
+		} else {
+			handler.obtainMessage(MSG_RELEASE).sendToTarget();
+		}
+	}
+
 	@Override
 	public void doRelease() {
 		long functionPointer = getPointer();
@@ -106,6 +181,11 @@ public class V8Function extends V8Object implements KrollFunction, Handler.Callb
 
 	// JNI method prototypes
 	private native Object nativeInvoke(long thisPointer, long functionPointer, Object[] functionArgs);
+	private native Object nativeInvokeMap(long thisPointer, long functionPointer, HashMap functionArg);
+	private static native boolean nativeQueueCall(V8Function function, KrollObject thisObject, Object[] functionArgs);
+	private static native long nativeQueueBlockingCall(V8Function function, KrollObject thisObject, Object[] functionArgs);
+	private static native boolean nativeAwaitCall(long completion, int timeout);
+	private static native Object nativeFinishCall(long completion);
 	private static native void nativeRelease(long functionPointer);
 }
 
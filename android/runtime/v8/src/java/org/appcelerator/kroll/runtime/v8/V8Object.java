@@ -6,15 +6,33 @@
  */
 package org.appcelerator.kroll.runtime.v8;
 
+import java.nio.ByteBuffer;
+import java.util.ArrayList;
+
 import org.appcelerator.kroll.KrollObject;
 import org.appcelerator.kroll.KrollRuntime;
 import org.appcelerator.kroll.common.Log;
+import org.appcelerator.kroll.common.TiMessenger;
 
 public class V8Object extends KrollObject
 {
 	private static final String TAG = "V8Object";
 
 	private volatile long ptr;
+	private boolean releaseQueued = false;
+
+	// Objects waiting to be released. The queue is drained on the
+	// runtime thread with a single call to nativeReleaseMany().
+	private static final ArrayList<V8Object> releaseQueue = new ArrayList<V8Object>();
+	private static boolean releaseScheduled = false;
+
+	private static final Runnable drainReleaseQueue = new Runnable() {
+		@Override
+		public void run()
+		{
+			drainReleaseQueue();
+		}
+	};
 
 	public V8Object(long ptr)
 	{
@@ -73,6 +91,24 @@ public class V8Object extends KrollObject
 		return nativeCallProperty(ptr, propertyName, args);
 	}
 
+	@Override
+	protected void release()
+	{
+		synchronized (releaseQueue) {
+			if (releaseQueued) {
+				return;
+			}
+			releaseQueued = true;
+			releaseQueue.add(this);
+			if (releaseScheduled) {
+				return;
+			}
+			releaseScheduled = true;
+		}
+
+		TiMessenger.postOnRuntime(drainReleaseQueue);
+	}
+
 	@Override
 	public void doRelease()
 	{
@@ -86,12 +122,78 @@ public class V8Object extends KrollObject
 		}
 	}
 
+	private static void drainReleaseQueue()
+	{
+		V8Object[] objects;
+		synchronized (releaseQueue) {
+			objects = releaseQueue.toArray(new V8Object[releaseQueue.size()]);
+			for (V8Object object : objects) {
+				object.releaseQueued = false;
+			}
+			releaseQueue.clear();
+			releaseScheduled = false;
+		}
+
+		long[] ptrs = new long[objects.length];
+		for (int i = 0; i < objects.length; i++) {
+			ptrs[i] = objects[i].ptr;
+		}
+
+		// Freed wrappers have their pointer cleared in the array.
+		int freed = nativeReleaseMany(ptrs);
+		for (int i = 0; i < objects.length; i++) {
+			if (ptrs[i] == 0) {
+				objects[i].ptr = 0;
+			}
+		}
+
+		if (freed > 0) {
+			KrollRuntime.suggestGC();
+		}
+
+		if (Log.isDebugModeEnabled()) {
+			Log.d(TAG, "Released " + objects.length + " objects: " + freed + " freed, "
+				+ (objects.length - freed) + " still attached", Log.DEBUG_MODE);
+		}
+	}
+
 	@Override
 	public void doSetWindow(Object windowProxyObject)
 	{
 		nativeSetWindow(ptr, windowProxyObject);
 	}
 
+	@Override
+	public void doSetExternalArrayData(ByteBuffer data)
+	{
+		nativeSetExternalArrayData(ptr, data);
+	}
+
+	@Override
+	public void doAdjustExternalMemory(long bytes)
+	{
+		nativeAdjustExternalMemory(ptr, bytes);
+	}
+
+	@Override
+	public void doSetBubbleParent(KrollObject parent, boolean linked)
+	{
+		if (ptr == 0) {
+			return;
+		}
+
+		long parentPtr = 0;
+		if (linked && parent instanceof V8Object) {
+			parentPtr = ((V8Object) parent).getPointer();
+
+			// The parent has been released, let Java find it when bubbling.
+			if (parentPtr == 0) {
+				linked = false;
+			}
+		}
+		nativeSetBubbleParent(ptr, parentPtr, linked);
+	}
+
 	@Override
 	protected void finalize() throws Throwable
 	{
@@ -103,12 +205,16 @@ public class V8Object extends KrollObject
 	}
 
 	// JNI method prototypes
-	protected static native void nativeInitObject(Class<?> proxyClass, Object proxyObject);
+	protected static native void nativeInitObject(Class<?> proxyClass, int proxyClassHash, Object proxyObject);
 	private static native Object nativeCallProperty(long ptr, String propertyName, Object[] args);
 	private static native boolean nativeRelease(long ptr);
+	private static native int nativeReleaseMany(long[] ptrs);
 
 	private native void nativeSetProperty(long ptr, String name, Object value);
 	private native boolean nativeFireEvent(long ptr, Object source, long sourcePtr, String event, Object data, boolean bubble, boolean reportSuccess, int code, String errorMessage);
 	private native void nativeSetWindow(long ptr, Object windowProxyObject);
+	private native void nativeSetExternalArrayData(long ptr, ByteBuffer data);
+	private native void nativeAdjustExternalMemory(long ptr, long bytes);
+	private native void nativeSetBubbleParent(long ptr, long parentPtr, boolean linked);
 }
 
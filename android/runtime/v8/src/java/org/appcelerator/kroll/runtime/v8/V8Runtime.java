@@ -14,12 +14,15 @@ import java.util.List;
 import java.util.Locale;
 import java.util.concurrent.atomic.AtomicBoolean;
 
+import org.appcelerator.kroll.KrollApplication;
 import org.appcelerator.kroll.KrollExternalModule;
 import org.appcelerator.kroll.KrollProxySupport;
 import org.appcelerator.kroll.KrollRuntime;
+import org.appcelerator.kroll.common.AsyncResult;
 import org.appcelerator.kroll.common.KrollSourceCodeProvider;
 import org.appcelerator.kroll.common.Log;
 import org.appcelerator.kroll.common.TiDeployData;
+import org.appcelerator.kroll.common.TiMessenger;
 
 import android.os.Build;
 import android.os.Handler;
@@ -32,7 +35,17 @@ public final class V8Runtime extends KrollRuntime implements Handler.Callback
 	private static final String TAG = "KrollV8Runtime";
 	private static final String NAME = "v8";
 	private static final int MSG_PROCESS_DEBUG_MESSAGES = KrollRuntime.MSG_LAST_ID + 100;
+	private static final int MSG_CONTINUE_IDLE_WORK = KrollRuntime.MSG_LAST_ID + 101;
+	private static final int MSG_TAKE_HEAP_SNAPSHOT = KrollRuntime.MSG_LAST_ID + 102;
+	private static final int MSG_START_ALLOCATION_TRACKING = KrollRuntime.MSG_LAST_ID + 103;
+	private static final int MSG_STOP_ALLOCATION_TRACKING = KrollRuntime.MSG_LAST_ID + 104;
+	private static final int MSG_START_CPU_PROFILING = KrollRuntime.MSG_LAST_ID + 105;
+	private static final int MSG_STOP_CPU_PROFILING = KrollRuntime.MSG_LAST_ID + 106;
 	private static final int MAX_V8_IDLE_INTERVAL = 30 * 1000; // ms
+	private static final int FRAME_INTERVAL = 16; // ms
+	// Idle work is limited to half a frame so events queued
+	// during an animation or a scroll are not delayed by a GC.
+	private static final int IDLE_TIME_BUDGET = FRAME_INTERVAL / 2; // ms
 
 	private boolean libLoaded = false;
 
@@ -44,6 +57,91 @@ public final class V8Runtime extends KrollRuntime implements Handler.Callback
 	private AtomicBoolean shouldGC = new AtomicBoolean(false);
 	private long lastV8Idle;
 
+	// Set while V8 has idle work left from the last round, runtime thread only.
+	private boolean idleWorkPending;
+
+	private final Runnable drainEvents = new Runnable() {
+		@Override
+		public void run()
+		{
+			nativeDrainEvents();
+		}
+	};
+
+	// Set while a drain of the native blocking call queue is pending on the runtime thread.
+	private static final AtomicBoolean blockingCallDrainScheduled = new AtomicBoolean(false);
+
+	// Set while a drain of the native asynchronous call queue is pending on the runtime thread.
+	private static final AtomicBoolean asyncCallDrainScheduled = new AtomicBoolean(false);
+
+	private static final Runnable drainBlockingCalls = new Runnable() {
+		@Override
+		public void run()
+		{
+			// Cleared before draining, so a call queued from now on schedules
+			// another drain if this one misses it.
+			blockingCallDrainScheduled.set(false);
+			nativeDrainCalls(true);
+		}
+	};
+
+	private static final Runnable drainAsyncCalls = new Runnable() {
+		@Override
+		public void run()
+		{
+			asyncCallDrainScheduled.set(false);
+			nativeDrainCalls(false);
+			V8Function.drainOverflowCalls();
+		}
+	};
+
+	/**
+	 * Schedules a drain of the blocking calls queued by V8Function on the runtime thread, unless
+	 * one is already pending. This goes through the runtime TiMessenger, so a runtime thread which
+	 * is itself blocked on another thread still runs the queued calls.
+	 */
+	static void scheduleBlockingCallDrain()
+	{
+		if (blockingCallDrainScheduled.compareAndSet(false, true)) {
+			TiMessenger.getRuntimeMessenger().post(drainBlockingCalls);
+		}
+	}
+
+	/**
+	 * Schedules a drain of the asynchronous calls queued by V8Function on the runtime thread,
+	 * unless one is already pending. Unlike blocking calls, these are run from the runtime Looper
+	 * only and never while the runtime thread waits on a blocking message.
+	 */
+	static void scheduleAsyncCallDrain()
+	{
+		if (asyncCallDrainScheduled.compareAndSet(false, true)) {
+			if (TiMessenger.getRuntimeMessenger() == null) {
+				asyncCallDrainScheduled.set(false);
+				return;
+			}
+			TiMessenger.postOnRuntime(drainAsyncCalls);
+		}
+	}
+
+	private static final Runnable drainAsyncMethods = new Runnable() {
+		@Override
+		public void run()
+		{
+			nativeDrainAsyncMethods();
+		}
+	};
+
+	/**
+	 * Called by the native worker threads of async Kroll methods, when the first of a batch
+	 * of results is ready to be delivered to JavaScript.
+	 */
+	static void scheduleAsyncMethodDrain()
+	{
+		// Posted to the Looper, so results are not delivered while the runtime thread waits
+		// on a blocking message.
+		TiMessenger.postOnRuntime(drainAsyncMethods);
+	}
+
 	@Override
 	public void initRuntime()
 	{
@@ -82,7 +180,9 @@ public final class V8Runtime extends KrollRuntime implements Handler.Callback
 			DBG = false;
 		}
 
-		nativeInit(useGlobalRefs, deployData.getDebuggerPort(), DBG, deployData.isProfilerEnabled());
+		KrollApplication app = getKrollApplication();
+		nativeInit(useGlobalRefs, deployData.getDebuggerPort(), DBG, deployData.isProfilerEnabled(),
+			app.isProfilingEnabled(), app.getMaxYoungSpaceSize(), app.getMaxOldSpaceSize());
 
 		if (deployData.isDebuggerEnabled()) {
 			dispatchDebugMessages();
@@ -103,20 +203,25 @@ public final class V8Runtime extends KrollRuntime implements Handler.Callback
 			@Override
 			public boolean queueIdle()
 			{
-				boolean willGC = shouldGC.getAndSet(false);
-				if (!willGC) {
-					// This means we haven't specifically been told to do
-					// a V8 GC (which is just a call to nativeIdle()), but nevertheless
-					// if more than the recommended time has passed since the last
-					// call to nativeIdle(), we'll want to do it anyways.
-					willGC = ((System.currentTimeMillis() - lastV8Idle) > MAX_V8_IDLE_INTERVAL);
+				// Only call into V8 when we have specifically been told to do a V8 GC,
+				// more than the recommended time has passed, or the last round left
+				// work to continue. The native scheduler then decides how much to do.
+				long now = System.currentTimeMillis();
+				boolean force = shouldGC.getAndSet(false) || ((now - lastV8Idle) > MAX_V8_IDLE_INTERVAL);
+				if (!force && !idleWorkPending) {
+					return true;
 				}
-				if (willGC) {
-					boolean gcWantsMore = !nativeIdle();
-					lastV8Idle = System.currentTimeMillis();
-					if (gcWantsMore) {
-						shouldGC.set(true);
-					}
+				if (force) {
+					lastV8Idle = now;
+				}
+				idleWorkPending = !nativeIdle(IDLE_TIME_BUDGET, force);
+				if (idleWorkPending) {
+					// Wake the looper on the next frame so the work continues even
+					// if no other message arrives. The native scheduler stops asking
+					// for this while it skips idle periods or backs off, so an idle
+					// runtime thread is not woken on every frame.
+					handler.removeMessages(MSG_CONTINUE_IDLE_WORK);
+					handler.sendEmptyMessageDelayed(MSG_CONTINUE_IDLE_WORK, FRAME_INTERVAL);
 				}
 				return true;
 			}
@@ -186,7 +291,10 @@ public final class V8Runtime extends KrollRuntime implements Handler.Callback
 	@Override
 	public void initObject(KrollProxySupport proxy)
 	{
-		V8Object.nativeInitObject(proxy.getClass(), proxy);
+		// The class hash keys the native proxy class registry, computing it here
+		// saves an upcall from native code.
+		Class<?> proxyClass = proxy.getClass();
+		V8Object.nativeInitObject(proxyClass, System.identityHashCode(proxyClass), proxy);
 	}
 
 	@Override
@@ -198,6 +306,42 @@ public final class V8Runtime extends KrollRuntime implements Handler.Callback
 				dispatchDebugMessages();
 
 				return true;
+
+			case MSG_CONTINUE_IDLE_WORK:
+				// Only used to trigger the idle handler again.
+				return true;
+
+			case MSG_TAKE_HEAP_SNAPSHOT: {
+				AsyncResult result = (AsyncResult) message.obj;
+				result.setResult(nativeTakeHeapSnapshot((String) result.getArg()));
+
+				return true;
+			}
+			case MSG_START_ALLOCATION_TRACKING: {
+				AsyncResult result = (AsyncResult) message.obj;
+				result.setResult(nativeStartAllocationTracking((String) result.getArg()));
+
+				return true;
+			}
+			case MSG_STOP_ALLOCATION_TRACKING: {
+				AsyncResult result = (AsyncResult) message.obj;
+				result.setResult(nativeStopAllocationTracking((String) result.getArg()));
+
+				return true;
+			}
+			case MSG_START_CPU_PROFILING: {
+				AsyncResult result = (AsyncResult) message.obj;
+				result.setResult(nativeStartCpuProfiling((String) result.getArg()));
+
+				return true;
+			}
+			case MSG_STOP_CPU_PROFILING: {
+				AsyncResult result = (AsyncResult) message.obj;
+				Object[] args = (Object[]) result.getArg();
+				result.setResult(nativeStopCpuProfiling((String) args[0], (String) args[1]));
+
+				return true;
+			}
 		}
 
 		return super.handleMessage(message);
@@ -236,12 +380,122 @@ public final class V8Runtime extends KrollRuntime implements Handler.Callback
 		shouldGC.set(true);
 	}
 
+	/**
+	 * Writes a snapshot of the JavaScript heap that can be loaded in Chrome DevTools.
+	 * Only available in development builds or when "ti.android.profiling" is enabled in tiapp.xml.
+	 * @param path the file to write, usually with the .heapsnapshot extension.
+	 * @return whether the snapshot was written.
+	 */
+	public boolean takeHeapSnapshot(String path)
+	{
+		if (isRuntimeThread()) {
+			return nativeTakeHeapSnapshot(path);
+		}
+		return (Boolean) TiMessenger.sendBlockingRuntimeMessage(handler.obtainMessage(MSG_TAKE_HEAP_SNAPSHOT), path);
+	}
+
+	/**
+	 * Starts tracking the objects allocated by JavaScript code and writes a first heap snapshot.
+	 * Objects allocated from now on have an id above the returned one.
+	 * @param path the file to write, usually with the .heapsnapshot extension.
+	 * @return the highest object id of the snapshot, -1 if tracking could not be started.
+	 * @see #stopAllocationTracking(String)
+	 */
+	public long startAllocationTracking(String path)
+	{
+		if (isRuntimeThread()) {
+			return nativeStartAllocationTracking(path);
+		}
+		return (Long) TiMessenger.sendBlockingRuntimeMessage(handler.obtainMessage(MSG_START_ALLOCATION_TRACKING), path);
+	}
+
+	/**
+	 * Stops tracking allocations and writes a heap snapshot in which the objects
+	 * allocated since the tracking started can be told apart by their id.
+	 * @param path the file to write, usually with the .heapsnapshot extension.
+	 * @return whether the snapshot was written.
+	 */
+	public boolean stopAllocationTracking(String path)
+	{
+		if (isRuntimeThread()) {
+			return nativeStopAllocationTracking(path);
+		}
+		return (Boolean) TiMessenger.sendBlockingRuntimeMessage(handler.obtainMessage(MSG_STOP_ALLOCATION_TRACKING), path);
+	}
+
+	/**
+	 * Starts sampling the JavaScript call stacks in a CPU profile.
+	 * Only available in development builds or when "ti.android.profiling" is enabled in tiapp.xml.
+	 * @param label the name of the profile, used to stop it.
+	 * @return whether the profile was started.
+	 */
+	public boolean startCpuProfiling(String label)
+	{
+		if (isRuntimeThread()) {
+			return nativeStartCpuProfiling(label);
+		}
+		return (Boolean) TiMessenger.sendBlockingRuntimeMessage(handler.obtainMessage(MSG_START_CPU_PROFILING), label);
+	}
+
+	/**
+	 * Stops a CPU profile and writes it in the format read by Chrome DevTools.
+	 * @param label the name given to {@link #startCpuProfiling(String)}.
+	 * @param path the file to write, usually with the .cpuprofile extension.
+	 * @return whether the profile was written.
+	 */
+	public boolean stopCpuProfiling(String label, String path)
+	{
+		if (isRuntimeThread()) {
+			return nativeStopCpuProfiling(label, path);
+		}
+		return (Boolean) TiMessenger.sendBlockingRuntimeMessage(handler.obtainMessage(MSG_STOP_CPU_PROFILING),
+			new Object[] { label, path });
+	}
+
+	/**
+	 * Logs the number of native wrappers created, alive, detached, re-attached,
+	 * collected and released for each proxy class. Can be called from any thread.
+	 */
+	public static void dumpProxyCensus()
+	{
+		nativeDumpProxyCensus();
+	}
+
+	@Override
+	public void doLowMemory(int level)
+	{
+		nativeLowMemory(level);
+	}
+
+	@Override
+	public boolean postEvent(KrollProxySupport proxy, String event, Object data, int coalescing)
+	{
+		// Only the post to an empty queue schedules a drain, the events
+		// posted until it runs are dispatched together.
+		if (nativePostEvent(proxy, event, data, coalescing)) {
+			TiMessenger.postOnRuntime(drainEvents);
+		}
+		return true;
+	}
+
 	// JNI method prototypes
-	private native void nativeInit(boolean useGlobalRefs, int debuggerPort, boolean DBG, boolean profilerEnabled);
+	private native void nativeInit(boolean useGlobalRefs, int debuggerPort, boolean DBG, boolean profilerEnabled,
+		boolean profilingEnabled, int maxYoungSpaceSize, int maxOldSpaceSize);
 	private native void nativeRunModule(String source, String filename, KrollProxySupport activityProxy);
 	private native Object nativeEvalString(String source, String filename);
 	private native void nativeProcessDebugMessages();
-	private native boolean nativeIdle();
+	private native boolean nativeIdle(int budget, boolean force);
+	private native void nativeLowMemory(int level);
+	private native boolean nativeTakeHeapSnapshot(String path);
+	private native long nativeStartAllocationTracking(String path);
+	private native boolean nativeStopAllocationTracking(String path);
+	private native boolean nativeStartCpuProfiling(String label);
+	private native boolean nativeStopCpuProfiling(String label, String path);
+	private static native void nativeDumpProxyCensus();
+	private static native boolean nativePostEvent(Object proxy, String event, Object data, int coalescing);
+	private native int nativeDrainEvents();
+	private static native int nativeDrainCalls(boolean blocking);
+	private static native int nativeDrainAsyncMethods();
 	private native void nativeDispose();
 	private native void nativeAddExternalCommonJsModule(String moduleName, KrollSourceCodeProvider sourceProvider);
 }
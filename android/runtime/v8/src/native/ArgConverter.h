@@ -0,0 +1,392 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#ifndef ARG_CONVERTER_H
+#define ARG_CONVERTER_H
+
+#include <jni.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <v8.h>
+
+#include "AndroidUtil.h"
+#include "JavaObject.h"
+#include "JNIUtil.h"
+#include "JSException.h"
+#include "Proxy.h"
+#include "TypeConverter.h"
+#include "V8Util.h"
+
+namespace titanium {
+
+// Tags for the Java types used by proxy methods. These mirror the
+// "typeInfo" table of the binding generator (ProxyBinding.fm).
+namespace jtype {
+	struct None {};
+	struct Void {};
+	struct Proxy {};
+	struct Exception {};
+	struct Dict {};
+	struct Object {};
+	struct String {};
+	struct Boolean {};
+	struct Short {};
+	struct Int {};
+	struct Long {};
+	struct Float {};
+	struct Double {};
+	struct StringArray {};
+	struct ObjectArray {};
+	struct ShortArray {};
+	struct IntArray {};
+	struct LongArray {};
+	struct FloatArray {};
+}
+
+// Converts arguments and return values between V8 and JNI for one Java type.
+// Each specialization provides:
+//
+//   check()     validates the type of a required JS argument, false if it has
+//               the wrong type. Optional arguments are not type checked.
+//   checkValue() validates any supplied JS argument, false if it can't be converted.
+//   toJava()    stores the JS argument into a jvalue. "release" is set when
+//               the value is a local reference that must be deleted.
+//   setDefault() stores the default value of an omitted optional argument.
+//   call()      invokes a Java method returning this type.
+//   toJS()      converts the Java return value into a JS value.
+template<typename T>
+struct ArgConverter;
+
+template<>
+struct ArgConverter<jtype::None>
+{
+};
+
+template<>
+struct ArgConverter<jtype::Void>
+{
+	typedef jboolean JavaType;
+
+	static inline JavaType call(JNIEnv *env, jobject object, jmethodID methodID, jvalue *args)
+	{
+		env->CallVoidMethodA(object, methodID, args);
+		return JNI_FALSE;
+	}
+
+	static inline v8::Handle<v8::Value> toJS(JNIEnv *env, JavaType)
+	{
+		return v8::Undefined();
+	}
+};
+
+// Object values returned to JS. A null result becomes JS null.
+struct ObjectResult
+{
+	typedef jobject JavaType;
+
+	static inline JavaType call(JNIEnv *env, jobject object, jmethodID methodID, jvalue *args)
+	{
+		return env->CallObjectMethodA(object, methodID, args);
+	}
+
+	static inline v8::Handle<v8::Value> toJS(JNIEnv *env, jobject result)
+	{
+		if (result == NULL) {
+			return v8::Null();
+		}
+		v8::Handle<v8::Value> jsResult = TypeConverter::javaObjectToJsValue(env, result);
+		env->DeleteLocalRef(result);
+		return jsResult;
+	}
+};
+
+// Object arguments converted with one of the TypeConverter functions
+// which report whether a new local reference was created.
+#define DEFINE_OBJECT_ARG_CONVERTER(tag, jsConverter, validation) \
+template<> \
+struct ArgConverter<jtype::tag> : public ObjectResult \
+{ \
+	static inline const char *expectedType() { return "Object"; } \
+	static inline bool check(v8::Local<v8::Value> value) { return validation; } \
+	static inline bool checkValue(v8::Local<v8::Value> value) { return true; } \
+	static inline void toJava(JNIEnv *env, v8::Local<v8::Value> value, jvalue& out, bool& release) \
+	{ \
+		out.l = TypeConverter::jsConverter(env, value, &release); \
+	} \
+	static inline void setDefault(jvalue& out) { out.l = NULL; } \
+};
+
+DEFINE_OBJECT_ARG_CONVERTER(Object, jsValueToJavaObject, true)
+DEFINE_OBJECT_ARG_CONVERTER(Exception, jsValueToJavaError, true)
+DEFINE_OBJECT_ARG_CONVERTER(Dict, jsObjectToJavaKrollDict, true)
+DEFINE_OBJECT_ARG_CONVERTER(Proxy, jsValueToJavaObject, value->IsObject() || value->IsNull())
+
+#undef DEFINE_OBJECT_ARG_CONVERTER
+
+template<>
+struct ArgConverter<jtype::String>
+{
+	typedef jstring JavaType;
+
+	static inline const char *expectedType() { return "Value"; }
+	static inline bool check(v8::Local<v8::Value> value) { return true; }
+	static inline bool checkValue(v8::Local<v8::Value> value) { return true; }
+	static inline void toJava(JNIEnv *env, v8::Local<v8::Value> value, jvalue& out, bool& release)
+	{
+		out.l = TypeConverter::jsValueToJavaString(env, value);
+		release = true;
+	}
+	static inline void setDefault(jvalue& out) { out.l = NULL; }
+
+	static inline JavaType call(JNIEnv *env, jobject object, jmethodID methodID, jvalue *args)
+	{
+		return (jstring) env->CallObjectMethodA(object, methodID, args);
+	}
+
+	static inline v8::Handle<v8::Value> toJS(JNIEnv *env, jstring result)
+	{
+		if (result == NULL) {
+			return v8::Null();
+		}
+		v8::Handle<v8::Value> jsResult = TypeConverter::javaStringToJsString(env, result);
+		env->DeleteLocalRef(result);
+		return jsResult;
+	}
+};
+
+// Java arrays, passed from and returned as JS arrays.
+#define DEFINE_ARRAY_ARG_CONVERTER(tag, javaArrayType, jsConverter) \
+template<> \
+struct ArgConverter<jtype::tag> \
+{ \
+	typedef javaArrayType JavaType; \
+	static inline const char *expectedType() { return "Array"; } \
+	static inline bool check(v8::Local<v8::Value> value) { return value->IsArray() || value->IsNull(); } \
+	static inline bool checkValue(v8::Local<v8::Value> value) { return true; } \
+	static inline void toJava(JNIEnv *env, v8::Local<v8::Value> value, jvalue& out, bool& release) \
+	{ \
+		out.l = TypeConverter::jsConverter(env, v8::Local<v8::Array>::Cast(value)); \
+		release = true; \
+	} \
+	static inline void setDefault(jvalue& out) { out.l = NULL; } \
+	static inline JavaType call(JNIEnv *env, jobject object, jmethodID methodID, jvalue *args) \
+	{ \
+		return (javaArrayType) env->CallObjectMethodA(object, methodID, args); \
+	} \
+	static inline v8::Handle<v8::Value> toJS(JNIEnv *env, JavaType result) \
+	{ \
+		if (result == NULL) { \
+			return v8::Null(); \
+		} \
+		v8::Handle<v8::Value> jsResult = TypeConverter::javaArrayToJsArray(env, result); \
+		env->DeleteLocalRef(result); \
+		return jsResult; \
+	} \
+};
+
+DEFINE_ARRAY_ARG_CONVERTER(StringArray, jobjectArray, jsArrayToJavaStringArray)
+DEFINE_ARRAY_ARG_CONVERTER(ObjectArray, jobjectArray, jsArrayToJavaArray)
+DEFINE_ARRAY_ARG_CONVERTER(ShortArray, jshortArray, jsArrayToJavaShortArray)
+DEFINE_ARRAY_ARG_CONVERTER(IntArray, jintArray, jsArrayToJavaIntArray)
+DEFINE_ARRAY_ARG_CONVERTER(LongArray, jlongArray, jsArrayToJavaLongArray)
+DEFINE_ARRAY_ARG_CONVERTER(FloatArray, jfloatArray, jsArrayToJavaFloatArray)
+
+#undef DEFINE_ARRAY_ARG_CONVERTER
+
+// Java numeric primitives. Strings that are not numbers are rejected,
+// null is passed as 0 and omitted optional arguments as -1.
+#define DEFINE_NUMBER_ARG_CONVERTER(tag, javaType, field, callType, jsConverter, javaConverter) \
+template<> \
+struct ArgConverter<jtype::tag> \
+{ \
+	typedef javaType JavaType; \
+	static inline const char *expectedType() { return "Number"; } \
+	static inline bool check(v8::Local<v8::Value> value) { return true; } \
+	static inline bool checkValue(v8::Local<v8::Value> value) \
+	{ \
+		return !((V8Util::isNaN(value) && !value->IsUndefined()) || value->ToString()->Length() == 0); \
+	} \
+	static inline void toJava(JNIEnv *env, v8::Local<v8::Value> value, jvalue& out, bool& release) \
+	{ \
+		out.field = TypeConverter::jsConverter(env, value->ToNumber()); \
+	} \
+	static inline void setDefault(jvalue& out) { out.field = -1; } \
+	static inline JavaType call(JNIEnv *env, jobject object, jmethodID methodID, jvalue *args) \
+	{ \
+		return env->Call##callType##MethodA(object, methodID, args); \
+	} \
+	static inline v8::Handle<v8::Value> toJS(JNIEnv *env, JavaType result) \
+	{ \
+		return TypeConverter::javaConverter(env, result); \
+	} \
+};
+
+DEFINE_NUMBER_ARG_CONVERTER(Short, jshort, s, Short, jsNumberToJavaShort, javaShortToJsNumber)
+DEFINE_NUMBER_ARG_CONVERTER(Int, jint, i, Int, jsNumberToJavaInt, javaIntToJsNumber)
+DEFINE_NUMBER_ARG_CONVERTER(Long, jlong, j, Long, jsNumberToJavaLong, javaLongToJsNumber)
+DEFINE_NUMBER_ARG_CONVERTER(Float, jfloat, f, Float, jsNumberToJavaFloat, javaFloatToJsNumber)
+DEFINE_NUMBER_ARG_CONVERTER(Double, jdouble, d, Double, jsNumberToJavaDouble, javaDoubleToJsNumber)
+
+#undef DEFINE_NUMBER_ARG_CONVERTER
+
+template<>
+struct ArgConverter<jtype::Boolean>
+{
+	typedef jboolean JavaType;
+
+	static inline const char *expectedType() { return "Boolean"; }
+	static inline bool check(v8::Local<v8::Value> value) { return value->IsBoolean() || value->IsNull(); }
+	static inline bool checkValue(v8::Local<v8::Value> value) { return true; }
+	static inline void toJava(JNIEnv *env, v8::Local<v8::Value> value, jvalue& out, bool& release)
+	{
+		out.z = TypeConverter::jsBooleanToJavaBoolean(env, value->ToBoolean());
+	}
+	static inline void setDefault(jvalue& out) { out.z = JNI_FALSE; }
+
+	static inline JavaType call(JNIEnv *env, jobject object, jmethodID methodID, jvalue *args)
+	{
+		return env->CallBooleanMethodA(object, methodID, args);
+	}
+
+	static inline v8::Handle<v8::Value> toJS(JNIEnv *env, jboolean result)
+	{
+		return TypeConverter::javaBooleanToJsBoolean(env, result);
+	}
+};
+
+// Converts the argument at "index" into jArguments. Returns false and
+// throws a JS error when the value does not have the expected type.
+// Same rules as the inline bindings (ProxyBinding.fm): only required
+// arguments are type checked and an optional argument takes its default
+// value only when it is omitted.
+template<typename T>
+inline bool convertArgument(JNIEnv *env, const v8::Arguments& args, int index, uint32_t optionalMask,
+	jvalue *jArguments, bool *release)
+{
+	bool isOptional = (optionalMask & (1 << index)) != 0;
+	if (isOptional && args.Length() <= index) {
+		ArgConverter<T>::setDefault(jArguments[index]);
+		return true;
+	}
+
+	v8::Local<v8::Value> value = args[index];
+	if ((!isOptional && !ArgConverter<T>::check(value)) || !ArgConverter<T>::checkValue(value)) {
+		char error[64];
+		snprintf(error, sizeof(error), "Invalid value, expected type %s.", ArgConverter<T>::expectedType());
+		LOGE("ArgConverter", error);
+		JSException::Error(error);
+		return false;
+	}
+
+	if (value->IsNull()) {
+		// Clears the whole jvalue: NULL for objects, 0 for primitives.
+		jArguments[index].j = 0;
+	} else {
+		ArgConverter<T>::toJava(env, value, jArguments[index], release[index]);
+	}
+	return true;
+}
+
+template<>
+inline bool convertArgument<jtype::None>(JNIEnv *, const v8::Arguments&, int, uint32_t, jvalue *, bool *)
+{
+	return true;
+}
+
+template<typename T>
+struct ArgCount
+{
+	enum { value = 1 };
+};
+
+template<>
+struct ArgCount<jtype::None>
+{
+	enum { value = 0 };
+};
+
+// Calls a Java proxy method from a V8 method callback. Generated bindings
+// instantiate this with the return and argument types of the method, so
+// methods sharing a signature share a single copy of the conversion code.
+// Methods with a KrollInvocation, variable arguments or more than six
+// arguments are still generated inline.
+template<typename Ret,
+	typename A0 = jtype::None, typename A1 = jtype::None, typename A2 = jtype::None,
+	typename A3 = jtype::None, typename A4 = jtype::None, typename A5 = jtype::None>
+struct JniCall
+{
+	enum {
+		argCount = ArgCount<A0>::value + ArgCount<A1>::value + ArgCount<A2>::value +
+			ArgCount<A3>::value + ArgCount<A4>::value + ArgCount<A5>::value
+	};
+
+	static v8::Handle<v8::Value> invoke(const v8::Arguments& args, jmethodID methodID, const char *name,
+		int requiredCount, uint32_t optionalMask)
+	{
+		v8::HandleScope scope;
+
+		JNIEnv *env = JNIScope::getEnv();
+		if (!env) {
+			return JSException::GetJNIEnvironmentError();
+		}
+
+		if (args.Length() < requiredCount) {
+			char error[128];
+			snprintf(error, sizeof(error), "%s: Invalid number of arguments. Expected %d but got %d",
+				name, requiredCount, args.Length());
+			return v8::ThrowException(v8::Exception::Error(v8::String::New(error)));
+		}
+
+		jvalue jArguments[argCount + 1];
+		bool release[argCount + 1];
+		for (int i = 0; i < argCount; ++i) {
+			release[i] = false;
+		}
+
+		if (!convertArgument<A0>(env, args, 0, optionalMask, jArguments, release) ||
+			!convertArgument<A1>(env, args, 1, optionalMask, jArguments, release) ||
+			!convertArgument<A2>(env, args, 2, optionalMask, jArguments, release) ||
+			!convertArgument<A3>(env, args, 3, optionalMask, jArguments, release) ||
+			!convertArgument<A4>(env, args, 4, optionalMask, jArguments, release) ||
+			!convertArgument<A5>(env, args, 5, optionalMask, jArguments, release)) {
+			releaseArguments(env, jArguments, release);
+			return v8::Undefined();
+		}
+
+		Proxy* proxy = Proxy::unwrap(args.Holder());
+		jobject javaProxy = proxy->getJavaObject();
+
+		typename ArgConverter<Ret>::JavaType jResult =
+			ArgConverter<Ret>::call(env, javaProxy, methodID, jArguments);
+
+		if (!JavaObject::useGlobalRefs) {
+			env->DeleteLocalRef(javaProxy);
+		}
+		releaseArguments(env, jArguments, release);
+
+		if (env->ExceptionCheck()) {
+			v8::Handle<v8::Value> jsException = JSException::fromJavaException();
+			env->ExceptionClear();
+			return jsException;
+		}
+
+		return scope.Close(ArgConverter<Ret>::toJS(env, jResult));
+	}
+
+private:
+	static inline void releaseArguments(JNIEnv *env, jvalue *jArguments, bool *release)
+	{
+		for (int i = 0; i < argCount; ++i) {
+			if (release[i]) {
+				env->DeleteLocalRef(jArguments[i].l);
+			}
+		}
+	}
+};
+
+}
+
+#endif
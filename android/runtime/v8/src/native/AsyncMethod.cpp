@@ -0,0 +1,438 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#include <deque>
+#include <set>
+#include <vector>
+#include <jni.h>
+#include <pthread.h>
+#include <v8.h>
+
+#include "AndroidUtil.h"
+#include "AsyncMethod.h"
+#include "EventEmitter.h"
+#include "JNIUtil.h"
+#include "TypeConverter.h"
+#include "V8Util.h"
+
+#define TAG "AsyncMethod"
+
+// Number of worker threads, started with the first call.
+#define WORKER_COUNT 3
+
+using namespace v8;
+
+namespace titanium {
+
+struct AsyncCall
+{
+	AsyncCall *next; // completed list
+
+	jobject javaProxy;
+	jmethodID methodID;
+	char returnType;
+	std::vector<jvalue> args;
+	std::vector<int> objectArgs; // indexes of the object arguments
+
+	jvalue result;
+	jstring error; // message of the exception thrown by the method
+
+	Persistent<Object> holder;
+	Persistent<Function> callback;
+};
+
+// Guards the call lists and initialized, so dispose()
+// sees every call in exactly one of them.
+static pthread_mutex_t queueMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queueCondition = PTHREAD_COND_INITIALIZER;
+static std::deque<AsyncCall*> pendingCalls;
+static std::set<AsyncCall*> runningCalls;
+static bool workersStarted = false;
+static bool initialized = false;
+
+// Workers push here, the KrollRuntime thread takes the whole list.
+static AsyncCall *completedCalls = NULL;
+
+static Persistent<String> resultSymbol;
+
+// Reads the argument and return types from a JNI method signature,
+// ex: "(ILjava/lang/String;[I)Ljava/lang/Object;".
+static void parseSignature(const char *signature, std::vector<int>& objectArgs, int *argCount, char *returnType)
+{
+	const char *c = signature + 1;
+	int index = 0;
+
+	while (*c != ')') {
+		bool isObject = false;
+		while (*c == '[') {
+			isObject = true;
+			c++;
+		}
+		if (*c == 'L') {
+			isObject = true;
+			while (*c != ';') {
+				c++;
+			}
+		}
+		if (isObject) {
+			objectArgs.push_back(index);
+		}
+		c++;
+		index++;
+	}
+
+	*argCount = index;
+	c++;
+	*returnType = (*c == '[') ? 'L' : *c;
+}
+
+static void callMethod(JNIEnv *env, AsyncCall *call)
+{
+	jvalue *args = call->args.empty() ? NULL : &call->args[0];
+
+	switch (call->returnType) {
+		case 'V':
+			env->CallVoidMethodA(call->javaProxy, call->methodID, args);
+			break;
+		case 'Z':
+			call->result.z = env->CallBooleanMethodA(call->javaProxy, call->methodID, args);
+			break;
+		case 'B':
+			call->result.b = env->CallByteMethodA(call->javaProxy, call->methodID, args);
+			break;
+		case 'C':
+			call->result.c = env->CallCharMethodA(call->javaProxy, call->methodID, args);
+			break;
+		case 'S':
+			call->result.s = env->CallShortMethodA(call->javaProxy, call->methodID, args);
+			break;
+		case 'I':
+			call->result.i = env->CallIntMethodA(call->javaProxy, call->methodID, args);
+			break;
+		case 'J':
+			call->result.j = env->CallLongMethodA(call->javaProxy, call->methodID, args);
+			break;
+		case 'F':
+			call->result.f = env->CallFloatMethodA(call->javaProxy, call->methodID, args);
+			break;
+		case 'D':
+			call->result.d = env->CallDoubleMethodA(call->javaProxy, call->methodID, args);
+			break;
+		default: {
+			jobject result = env->CallObjectMethodA(call->javaProxy, call->methodID, args);
+			if (result) {
+				call->result.l = env->NewGlobalRef(result);
+				env->DeleteLocalRef(result);
+			}
+		}
+	}
+
+	if (env->ExceptionCheck()) {
+		jthrowable exception = env->ExceptionOccurred();
+		env->ExceptionClear();
+
+		jstring message = (jstring) env->CallObjectMethod(exception, JNIUtil::throwableGetMessageMethod);
+		if (env->ExceptionCheck()) {
+			env->ExceptionClear();
+			message = NULL;
+		}
+		if (!message) {
+			message = env->NewStringUTF("Java Exception occurred");
+		}
+		call->error = (jstring) env->NewGlobalRef(message);
+		env->DeleteLocalRef(message);
+		env->DeleteLocalRef(exception);
+	}
+
+	// The arguments are no longer needed, release them on this thread.
+	for (std::vector<int>::iterator i = call->objectArgs.begin(); i != call->objectArgs.end(); ++i) {
+		if (call->args[*i].l) {
+			env->DeleteGlobalRef(call->args[*i].l);
+			call->args[*i].l = NULL;
+		}
+	}
+}
+
+// Releases the Java references of the call, from any thread.
+static void freeJavaReferences(JNIEnv *env, AsyncCall *call)
+{
+	env->DeleteGlobalRef(call->javaProxy);
+	for (std::vector<int>::iterator i = call->objectArgs.begin(); i != call->objectArgs.end(); ++i) {
+		if (call->args[*i].l) {
+			env->DeleteGlobalRef(call->args[*i].l);
+		}
+	}
+	if (call->returnType == 'L' && call->result.l) {
+		env->DeleteGlobalRef(call->result.l);
+	}
+	if (call->error) {
+		env->DeleteGlobalRef(call->error);
+	}
+}
+
+// Frees the call on the KrollRuntime thread.
+static void freeCall(JNIEnv *env, AsyncCall *call)
+{
+	freeJavaReferences(env, call);
+	call->holder.Dispose();
+	call->callback.Dispose();
+	delete call;
+}
+
+static void complete(JNIEnv *env, AsyncCall *call)
+{
+	pthread_mutex_lock(&queueMutex);
+
+	// dispose() already released the JS handles of a call
+	// it found running, the worker frees the rest.
+	if (runningCalls.erase(call) == 0) {
+		pthread_mutex_unlock(&queueMutex);
+		freeJavaReferences(env, call);
+		delete call;
+		return;
+	}
+
+	AsyncCall *list = completedCalls;
+	call->next = list;
+	completedCalls = call;
+	pthread_mutex_unlock(&queueMutex);
+
+	// Only the push to an empty list schedules a drain.
+	if (!list) {
+		env->CallStaticVoidMethod(JNIUtil::v8RuntimeClass, JNIUtil::v8RuntimeScheduleAsyncMethodDrainMethod);
+		if (env->ExceptionCheck()) {
+			env->ExceptionClear();
+			LOGE(TAG, "Unable to schedule the delivery of async method results");
+		}
+	}
+}
+
+static void* workerMain(void *arg)
+{
+	JNIEnv *env = JNIUtil::getJNIEnv();
+	if (!env) {
+		LOGE(TAG, "Unable to attach an async method worker to the VM");
+		return NULL;
+	}
+
+	for (;;) {
+		pthread_mutex_lock(&queueMutex);
+		while (pendingCalls.empty()) {
+			pthread_cond_wait(&queueCondition, &queueMutex);
+		}
+		AsyncCall *call = pendingCalls.front();
+		pendingCalls.pop_front();
+		runningCalls.insert(call);
+		pthread_mutex_unlock(&queueMutex);
+
+		callMethod(env, call);
+		complete(env, call);
+	}
+
+	return NULL;
+}
+
+static void startWorkers()
+{
+	for (int i = 0; i < WORKER_COUNT; i++) {
+		pthread_t thread;
+		pthread_attr_t attributes;
+		pthread_attr_init(&attributes);
+		pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+
+		if (pthread_create(&thread, &attributes, workerMain, NULL) != 0) {
+			LOGE(TAG, "Unable to start async method worker %d", i);
+		}
+		pthread_attr_destroy(&attributes);
+	}
+	workersStarted = true;
+}
+
+static Handle<Value> resultToJsValue(JNIEnv *env, AsyncCall *call)
+{
+	switch (call->returnType) {
+		case 'V':
+			return Undefined();
+		case 'Z':
+			return TypeConverter::javaBooleanToJsBoolean(call->result.z);
+		case 'B':
+			return Integer::New(call->result.b);
+		case 'C':
+			return Integer::New(call->result.c);
+		case 'S':
+			return TypeConverter::javaShortToJsNumber(call->result.s);
+		case 'I':
+			return TypeConverter::javaIntToJsNumber(call->result.i);
+		case 'J':
+			return TypeConverter::javaLongToJsNumber(call->result.j);
+		case 'F':
+			return TypeConverter::javaFloatToJsNumber(call->result.f);
+		case 'D':
+			return TypeConverter::javaDoubleToJsNumber(call->result.d);
+		default:
+			if (!call->result.l) {
+				return Null();
+			}
+			return TypeConverter::javaObjectToJsValue(env, call->result.l);
+	}
+}
+
+void AsyncMethod::init()
+{
+	pthread_mutex_lock(&queueMutex);
+	initialized = true;
+	pthread_mutex_unlock(&queueMutex);
+}
+
+bool AsyncMethod::invoke(JNIEnv *env, jobject javaProxy, jmethodID methodID, const char *signature,
+	jvalue *args, Handle<Object> holder, Handle<Function> callback)
+{
+	// Only the KrollRuntime thread adds calls, so the queue
+	// cannot fill up between this check and the push below.
+	pthread_mutex_lock(&queueMutex);
+	bool accepted = initialized && pendingCalls.size() < (size_t) MAX_PENDING_CALLS;
+	pthread_mutex_unlock(&queueMutex);
+
+	if (!accepted) {
+		return false;
+	}
+
+	AsyncCall *call = new AsyncCall();
+	call->next = NULL;
+	call->javaProxy = env->NewGlobalRef(javaProxy);
+	call->methodID = methodID;
+	call->result.j = 0;
+	call->error = NULL;
+
+	int argCount;
+	parseSignature(signature, call->objectArgs, &argCount, &call->returnType);
+
+	// The caller releases its local references after this returns,
+	// the worker owns global ones.
+	if (argCount > 0) {
+		call->args.assign(args, args + argCount);
+		for (std::vector<int>::iterator i = call->objectArgs.begin(); i != call->objectArgs.end(); ++i) {
+			if (call->args[*i].l) {
+				call->args[*i].l = env->NewGlobalRef(call->args[*i].l);
+			}
+		}
+	}
+
+	call->holder = Persistent<Object>::New(holder);
+	if (!callback.IsEmpty()) {
+		call->callback = Persistent<Function>::New(callback);
+	}
+
+	pthread_mutex_lock(&queueMutex);
+	if (!workersStarted) {
+		startWorkers();
+	}
+	pendingCalls.push_back(call);
+	pthread_cond_signal(&queueCondition);
+	pthread_mutex_unlock(&queueMutex);
+	return true;
+}
+
+int AsyncMethod::drain(JNIEnv *env)
+{
+	// Calls completed before the dispose were freed by it,
+	// and later ones are freed by their worker.
+	if (!initialized) {
+		return 0;
+	}
+
+	pthread_mutex_lock(&queueMutex);
+	AsyncCall *list = completedCalls;
+	completedCalls = NULL;
+	pthread_mutex_unlock(&queueMutex);
+
+	// Deliver in completion order.
+	AsyncCall *ordered = NULL;
+	while (list) {
+		AsyncCall *next = list->next;
+		list->next = ordered;
+		ordered = list;
+		list = next;
+	}
+
+	HandleScope scope;
+
+	int delivered = 0;
+	while (ordered) {
+		AsyncCall *call = ordered;
+		ordered = call->next;
+
+		if (!call->callback.IsEmpty()) {
+			HandleScope callScope;
+			Local<Object> event = Object::New();
+
+			if (call->error) {
+				event->Set(EventEmitter::successSymbol, False());
+				event->Set(EventEmitter::codeSymbol, Integer::New(-1));
+				event->Set(EventEmitter::errorSymbol, TypeConverter::javaStringToJsString(env, call->error));
+			} else {
+				if (resultSymbol.IsEmpty()) {
+					resultSymbol = SYMBOL_LITERAL("result");
+				}
+				event->Set(EventEmitter::successSymbol, True());
+				event->Set(EventEmitter::codeSymbol, Integer::New(0));
+				event->Set(resultSymbol, resultToJsValue(env, call));
+			}
+
+			TryCatch tryCatch;
+			Handle<Value> argv[] = { event };
+			call->callback->Call(call->holder, 1, argv);
+
+			if (tryCatch.HasCaught()) {
+				V8Util::openJSErrorDialog(tryCatch);
+				V8Util::reportException(tryCatch);
+			}
+			delivered++;
+		}
+
+		freeCall(env, call);
+	}
+
+	return delivered;
+}
+
+void AsyncMethod::dispose(JNIEnv *env)
+{
+	pthread_mutex_lock(&queueMutex);
+	initialized = false;
+
+	std::deque<AsyncCall*> calls;
+	calls.swap(pendingCalls);
+
+	AsyncCall *completed = completedCalls;
+	completedCalls = NULL;
+
+	// The worker frees a call it does not find in runningCalls.
+	for (std::set<AsyncCall*>::iterator i = runningCalls.begin(); i != runningCalls.end(); ++i) {
+		(*i)->holder.Dispose();
+		(*i)->holder = Persistent<Object>();
+		(*i)->callback.Dispose();
+		(*i)->callback = Persistent<Function>();
+	}
+	runningCalls.clear();
+	pthread_mutex_unlock(&queueMutex);
+
+	for (std::deque<AsyncCall*>::iterator i = calls.begin(); i != calls.end(); ++i) {
+		freeCall(env, *i);
+	}
+	while (completed) {
+		AsyncCall *next = completed->next;
+		freeCall(env, completed);
+		completed = next;
+	}
+
+	if (!resultSymbol.IsEmpty()) {
+		resultSymbol.Dispose();
+		resultSymbol = Persistent<String>();
+	}
+}
+
+} // namespace titanium
@@ -0,0 +1,51 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#ifndef ASYNC_METHOD_H
+#define ASYNC_METHOD_H
+
+#include <jni.h>
+#include <v8.h>
+
+namespace titanium {
+
+// Calls of Java methods annotated with @Kroll.method(async = true).
+// The generated binding converts the arguments on the KrollRuntime thread,
+// then the Java method runs on a small pool of worker threads. The result
+// is converted back on the KrollRuntime thread and passed to the JS
+// callback as { success: true, code: 0, result: ... }, or
+// { success: false, code: -1, error: ... } if the method threw.
+class AsyncMethod
+{
+public:
+	// Maximum number of calls waiting for a worker thread.
+	static const int MAX_PENDING_CALLS = 64;
+
+	// Accepts calls until the next dispose(), called on the KrollRuntime
+	// thread once the runtime is initialized.
+	static void init();
+
+	// Queues the call on the worker pool. The proxy and the object arguments
+	// are local references owned by the caller, signature is the method's
+	// JNI signature. The callback may be empty.
+	// Returns false without queuing the call if MAX_PENDING_CALLS calls
+	// are already waiting, or if the runtime is disposed.
+	static bool invoke(JNIEnv *env, jobject javaProxy, jmethodID methodID, const char *signature,
+		jvalue *args, v8::Handle<v8::Object> holder, v8::Handle<v8::Function> callback);
+
+	// Delivers the results of the completed calls on the KrollRuntime thread.
+	// Returns the number of calls completed.
+	static int drain(JNIEnv *env);
+
+	// Frees the waiting calls and the completed ones, and releases the
+	// JS handles of the calls still running. Those are freed by their
+	// worker thread once the Java method returns.
+	static void dispose(JNIEnv *env);
+};
+
+} // namespace titanium
+
+#endif
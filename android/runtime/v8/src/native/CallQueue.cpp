@@ -0,0 +1,218 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#include <jni.h>
+#include <linux/futex.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <v8.h>
+
+#include "AndroidUtil.h"
+#include "CallQueue.h"
+#include "JNIUtil.h"
+#include "RingBuffer.h"
+#include "V8Function.h"
+
+#define TAG "CallQueue"
+
+// Number of calls each ring buffer holds, must be a power of two.
+#define CAPACITY 256
+
+using namespace v8;
+
+namespace titanium {
+
+struct QueuedCall
+{
+	jobject function;   // V8Function
+	jobject thisObject; // V8Object
+	jobjectArray args;
+	CallQueue::Completion *completion; // NULL for asynchronous calls
+};
+
+typedef RingBuffer<QueuedCall, CAPACITY> CallRing;
+
+static CallRing asyncCalls;
+static CallRing blockingCalls;
+static volatile bool initialized = false;
+
+// Producers between their check of initialized and the end of their
+// enqueue. dispose() waits for them, so no call lands in a ring after
+// it was flushed.
+static volatile int32_t activeProducers = 0;
+
+static void freeCall(JNIEnv *env, const QueuedCall& call)
+{
+	env->DeleteGlobalRef(call.function);
+	env->DeleteGlobalRef(call.thisObject);
+	if (call.args) {
+		env->DeleteGlobalRef(call.args);
+	}
+}
+
+static bool postCall(JNIEnv *env, jobject function, jobject thisObject, jobjectArray args,
+	CallQueue::Completion *completion)
+{
+	if (!thisObject) {
+		return false;
+	}
+
+	__sync_fetch_and_add(&activeProducers, 1);
+	if (!initialized) {
+		__sync_fetch_and_sub(&activeProducers, 1);
+		return false;
+	}
+
+	QueuedCall call;
+	call.function = env->NewGlobalRef(function);
+	call.thisObject = env->NewGlobalRef(thisObject);
+	call.args = args ? (jobjectArray) env->NewGlobalRef(args) : NULL;
+	call.completion = completion;
+
+	CallRing& ring = completion ? blockingCalls : asyncCalls;
+	bool queued = ring.push(call);
+	__sync_fetch_and_sub(&activeProducers, 1);
+
+	if (!queued) {
+		freeCall(env, call);
+	}
+	return queued;
+}
+
+static void complete(JNIEnv *env, CallQueue::Completion *completion, jobject result)
+{
+	completion->result = result ? env->NewGlobalRef(result) : NULL;
+	__sync_synchronize();
+	completion->done = 1;
+	syscall(__NR_futex, &completion->done, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+bool CallQueue::post(JNIEnv *env, jobject function, jobject thisObject, jobjectArray args)
+{
+	return postCall(env, function, thisObject, args, NULL);
+}
+
+CallQueue::Completion* CallQueue::postBlocking(JNIEnv *env, jobject function, jobject thisObject, jobjectArray args)
+{
+	Completion *completion = new Completion();
+	completion->done = 0;
+	completion->result = NULL;
+
+	if (!postCall(env, function, thisObject, args, completion)) {
+		delete completion;
+		return NULL;
+	}
+	return completion;
+}
+
+bool CallQueue::await(Completion *completion, int timeout)
+{
+	if (!completion->done) {
+		struct timespec ts;
+		ts.tv_sec = timeout / 1000;
+		ts.tv_nsec = (timeout % 1000) * 1000000L;
+
+		// Returns early on a wake up, a timeout or a signal,
+		// the caller loops until the call is done.
+		syscall(__NR_futex, &completion->done, FUTEX_WAIT, 0, &ts, NULL, 0);
+	}
+
+	__sync_synchronize();
+	return completion->done != 0;
+}
+
+jobject CallQueue::finish(JNIEnv *env, Completion *completion)
+{
+	jobject result = NULL;
+	if (completion->result) {
+		result = env->NewLocalRef(completion->result);
+		env->DeleteGlobalRef(completion->result);
+	}
+	delete completion;
+	return result;
+}
+
+void CallQueue::init()
+{
+	asyncCalls.reset();
+	blockingCalls.reset();
+	initialized = true;
+	__sync_synchronize();
+}
+
+int CallQueue::drain(JNIEnv *env, bool blocking)
+{
+	if (!initialized) {
+		return 0;
+	}
+
+	CallRing& ring = blocking ? blockingCalls : asyncCalls;
+
+	// Calls queued while this batch runs are left for the next drain.
+	uint32_t mark = ring.pushed();
+	int called = 0;
+
+	HandleScope scope;
+	QueuedCall call;
+
+	while (ring.pop(&call, mark)) {
+		HandleScope callScope;
+
+		jlong functionPointer = env->GetLongField(call.function, JNIUtil::v8ObjectPtrField);
+		jlong thisPointer = env->GetLongField(call.thisObject, JNIUtil::v8ObjectPtrField);
+
+		jobject result = NULL;
+		if (functionPointer && thisPointer) {
+			result = V8Function::invoke(env, thisPointer, functionPointer, call.args);
+			called++;
+		} else {
+			LOGW(TAG, "Function or object released before a queued call, skipping");
+		}
+
+		if (call.completion) {
+			complete(env, call.completion, result);
+		}
+		if (result) {
+			env->DeleteLocalRef(result);
+		}
+		freeCall(env, call);
+	}
+
+	return called;
+}
+
+void CallQueue::dispose(JNIEnv *env)
+{
+	if (!initialized) {
+		return;
+	}
+
+	initialized = false;
+	__sync_synchronize();
+
+	// A producer which saw initialized set is still enqueuing, its call
+	// must be flushed below or its blocking caller would wait forever.
+	while (activeProducers > 0) {
+		sched_yield();
+	}
+
+	// The rings are only flushed once every claimed cell is published,
+	// which the wait above guarantees.
+	CallRing* rings[] = { &asyncCalls, &blockingCalls };
+	for (int i = 0; i < 2; i++) {
+		QueuedCall call;
+		while (rings[i]->pop(&call)) {
+			if (call.completion) {
+				complete(env, call.completion, NULL);
+			}
+			freeCall(env, call);
+		}
+	}
+}
+
+} // namespace titanium
@@ -0,0 +1,69 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#ifndef CALL_QUEUE_H
+#define CALL_QUEUE_H
+
+#include <jni.h>
+#include <stdint.h>
+
+namespace titanium {
+
+// Calls into JS functions made from threads other than the KrollRuntime
+// thread. Producers enqueue into fixed size ring buffers without taking
+// a lock, and the KrollRuntime thread runs all the queued calls in one
+// batch. The caller of a blocking call waits on a completion slot, which
+// is a futex word set by the runtime thread once the call returned.
+//
+// Asynchronous and blocking calls are kept in separate queues. Blocking
+// calls are drained through the runtime TiMessenger, which also runs while
+// the runtime thread itself waits on another thread. Asynchronous calls
+// are drained from the runtime Looper only, so they never run re-entrantly
+// inside a blocking message.
+class CallQueue
+{
+public:
+	struct Completion
+	{
+		volatile int32_t done;
+		jobject result; // global reference, NULL if the call threw
+	};
+
+	// Sets up the empty queue, called on the KrollRuntime thread before
+	// any function can be called from another thread.
+	static void init();
+
+	// Queues a call of the V8Function on the KrollObject, args may be NULL.
+	// Returns false if the queue is full or disposed.
+	static bool post(JNIEnv *env, jobject function, jobject thisObject, jobjectArray args);
+
+	// Same as post(), but returns the completion slot the caller waits on,
+	// or NULL if the queue is full or disposed. The caller then falls back
+	// to a runtime message.
+	static Completion* postBlocking(JNIEnv *env, jobject function, jobject thisObject, jobjectArray args);
+
+	// Waits at most timeout milliseconds for the call to complete.
+	// Returns true once it has.
+	static bool await(Completion *completion, int timeout);
+
+	// Returns the result of a completed call as a local reference
+	// and frees the completion slot.
+	static jobject finish(JNIEnv *env, Completion *completion);
+
+	// Runs the queued blocking or asynchronous calls on the KrollRuntime
+	// thread. Calls queued by the called functions wait for the next drain.
+	// Returns the number of calls made.
+	static int drain(JNIEnv *env, bool blocking);
+
+	// Discards the queued calls and refuses new ones until the next init().
+	// Blocking callers are released with a NULL result, including those
+	// of calls enqueued concurrently with the dispose.
+	static void dispose(JNIEnv *env);
+};
+
+} // namespace titanium
+
+#endif
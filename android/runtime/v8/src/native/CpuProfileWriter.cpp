@@ -0,0 +1,105 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#include <stdarg.h>
+
+#include "CpuProfileWriter.h"
+
+namespace titanium {
+
+CpuProfileWriter::CpuProfileWriter(FILE *file)
+	: file_(file)
+	, failed_(false)
+	, nextId_(1)
+	, startTime_(0)
+	, endTime_(0)
+{
+}
+
+void CpuProfileWriter::begin(double startTime, double endTime)
+{
+	startTime_ = startTime;
+	endTime_ = endTime;
+	write("{\"head\":");
+}
+
+void CpuProfileWriter::beginNode(const char *functionName, const char *url, int lineNumber,
+	unsigned int hitCount, unsigned int callUID)
+{
+	if (!firstChild_.empty()) {
+		if (!firstChild_.back()) {
+			write(",");
+		}
+		firstChild_.back() = false;
+	}
+
+	write("{\"functionName\":");
+	writeString(functionName);
+	write(",\"scriptId\":\"0\",\"url\":");
+	writeString(url);
+	write(",\"lineNumber\":%d,\"columnNumber\":0,\"hitCount\":%u,\"callUID\":%u,\"id\":%u,\"children\":[",
+		lineNumber, hitCount, callUID, nextId_++);
+
+	firstChild_.push_back(true);
+}
+
+void CpuProfileWriter::endNode()
+{
+	write("]}");
+	firstChild_.pop_back();
+}
+
+bool CpuProfileWriter::end()
+{
+	// Individual samples are not recorded, DevTools builds
+	// its views from the hit counts of the nodes.
+	write(",\"startTime\":%.6f,\"endTime\":%.6f,\"samples\":[]}", startTime_, endTime_);
+	return !failed_ && firstChild_.empty();
+}
+
+void CpuProfileWriter::writeString(const char *value)
+{
+	if (fputc('"', file_) == EOF) {
+		failed_ = true;
+	}
+
+	for (const unsigned char *c = (const unsigned char *) value; c && *c; ++c) {
+		int result;
+		switch (*c) {
+			case '"': result = fputs("\\\"", file_); break;
+			case '\\': result = fputs("\\\\", file_); break;
+			case '\n': result = fputs("\\n", file_); break;
+			case '\r': result = fputs("\\r", file_); break;
+			case '\t': result = fputs("\\t", file_); break;
+			default:
+				if (*c < 0x20) {
+					result = fprintf(file_, "\\u%04x", *c);
+				} else {
+					// UTF-8 sequences are copied as is.
+					result = fputc(*c, file_);
+				}
+		}
+		if (result < 0) {
+			failed_ = true;
+		}
+	}
+
+	if (fputc('"', file_) == EOF) {
+		failed_ = true;
+	}
+}
+
+void CpuProfileWriter::write(const char *format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	if (vfprintf(file_, format, args) < 0) {
+		failed_ = true;
+	}
+	va_end(args);
+}
+
+} // namespace titanium
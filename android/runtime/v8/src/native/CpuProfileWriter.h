@@ -0,0 +1,50 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#ifndef TI_KROLL_CPU_PROFILE_WRITER_H
+#define TI_KROLL_CPU_PROFILE_WRITER_H
+
+#include <stdio.h>
+#include <vector>
+
+namespace titanium {
+
+// Streams a call tree to a file in the .cpuprofile JSON format
+// read by Chrome DevTools. It does not depend on V8 or Android,
+// so it can be built and checked on the host.
+//
+// Nodes are written depth first: every beginNode() is matched
+// by an endNode() once all of its children have been written.
+class CpuProfileWriter
+{
+public:
+	CpuProfileWriter(FILE *file);
+
+	// Times are in seconds.
+	void begin(double startTime, double endTime);
+	void beginNode(const char *functionName, const char *url, int lineNumber,
+		unsigned int hitCount, unsigned int callUID);
+	void endNode();
+
+	// Returns false if any write failed.
+	bool end();
+
+private:
+	void writeString(const char *value);
+	void write(const char *format, ...);
+
+	FILE *file_;
+	bool failed_;
+	unsigned int nextId_;
+	double startTime_;
+	double endTime_;
+	// One entry per open node, true until its first child is written.
+	std::vector<bool> firstChild_;
+};
+
+} // namespace titanium
+
+#endif
@@ -0,0 +1,107 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#ifndef EVENT_COALESCER_H
+#define EVENT_COALESCER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace titanium {
+
+// The coalescing rules of the EventQueue, independent of how events are
+// stored. An Event has a coalescing mode and a next pointer, the Policy
+// compares and merges them:
+//
+//   bool sameTarget(Event *a, Event *b)    same proxy and event type
+//   void accumulate(Event *kept, Event *earlier)
+//                                          adds the data of an earlier event
+//                                          to the history of the kept one
+//   void supersede(Event *pending, Event *incoming)
+//                                          moves the data of a newer event
+//                                          into the pending one
+//   void finish(Event *kept)               called once per coalescable
+//                                          event kept in a batch
+//   void release(Event *event)             frees a coalesced event
+class EventCoalescer
+{
+public:
+	enum Mode
+	{
+		NONE = 0,      // every event is dispatched (ex: click)
+		LATEST = 1,    // only the latest pending event is dispatched (ex: scroll)
+		ACCUMULATE = 2 // the latest event carries the data of the earlier ones (ex: touchmove)
+	};
+
+	// Coalesces a batch of events given in posting order. Walks the batch
+	// from the newest event, so the event kept for each proxy and event
+	// type is the latest one. Earlier events are released and cleared
+	// from the batch. Returns the number of events coalesced.
+	template <typename Event, typename Policy>
+	static uint32_t coalesce(std::vector<Event*>& events, Policy& policy)
+	{
+		std::vector<Event*> latest;
+		uint32_t coalesced = 0;
+
+		for (typename std::vector<Event*>::reverse_iterator i = events.rbegin(); i != events.rend(); ++i) {
+			Event *event = *i;
+			if (event->coalescing == NONE) {
+				continue;
+			}
+
+			Event *kept = NULL;
+			for (typename std::vector<Event*>::iterator j = latest.begin(); j != latest.end(); ++j) {
+				if (policy.sameTarget(*j, event)) {
+					kept = *j;
+					break;
+				}
+			}
+
+			if (!kept) {
+				latest.push_back(event);
+				continue;
+			}
+
+			if (kept->coalescing == ACCUMULATE) {
+				policy.accumulate(kept, event);
+			}
+			policy.release(event);
+			*i = NULL;
+			++coalesced;
+		}
+
+		for (typename std::vector<Event*>::iterator i = latest.begin(); i != latest.end(); ++i) {
+			policy.finish(*i);
+		}
+
+		return coalesced;
+	}
+
+	// Merges an incoming event into the newest pending event of the same
+	// proxy and type, linked from head through next. Used when the queue is
+	// full, so the latest state still reaches JavaScript. Returns false if
+	// the event is not coalescable or no such event is pending.
+	template <typename Event, typename Policy>
+	static bool supersede(Event *head, Event *incoming, Policy& policy)
+	{
+		if (incoming->coalescing == NONE) {
+			return false;
+		}
+
+		for (Event *pending = head; pending; pending = pending->next) {
+			if (pending->coalescing != NONE && policy.sameTarget(pending, incoming)) {
+				policy.supersede(pending, incoming);
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+} // namespace titanium
+
+#endif
@@ -25,7 +25,23 @@ namespace titanium {
 Persistent<FunctionTemplate> EventEmitter::constructorTemplate;
 
 static Persistent<String> eventsSymbol;
+static Persistent<String> nativeEventSymbol;
+static Persistent<String> listenerSymbol;
+static Persistent<String> selfSymbol;
+static Persistent<String> viewSymbol;
+static Persistent<String> hasJavaListenerSymbol;
+static Persistent<String> onEventFiredSymbol;
+static Persistent<String> fireEventToParentSymbol;
+static Persistent<ObjectTemplate> eventTemplate;
+
 Persistent<String> EventEmitter::emitSymbol;
+Persistent<String> EventEmitter::typeSymbol;
+Persistent<String> EventEmitter::sourceSymbol;
+Persistent<String> EventEmitter::bubblesSymbol;
+Persistent<String> EventEmitter::cancelBubbleSymbol;
+Persistent<String> EventEmitter::successSymbol;
+Persistent<String> EventEmitter::codeSymbol;
+Persistent<String> EventEmitter::errorSymbol;
 
 Handle<Value> EventEmitter::eventEmitterConstructor(const Arguments& args)
 {
@@ -46,6 +62,231 @@ void EventEmitter::initTemplate()
 
 	eventsSymbol = SYMBOL_LITERAL("_events");
 	emitSymbol = SYMBOL_LITERAL("emit");
+	nativeEventSymbol = SYMBOL_LITERAL("_nativeEvent");
+	listenerSymbol = SYMBOL_LITERAL("listener");
+	selfSymbol = SYMBOL_LITERAL("self");
+	viewSymbol = SYMBOL_LITERAL("view");
+	hasJavaListenerSymbol = SYMBOL_LITERAL("_hasJavaListener");
+	onEventFiredSymbol = SYMBOL_LITERAL("_onEventFired");
+	fireEventToParentSymbol = SYMBOL_LITERAL("_fireEventToParent");
+	typeSymbol = SYMBOL_LITERAL("type");
+	sourceSymbol = SYMBOL_LITERAL("source");
+	bubblesSymbol = SYMBOL_LITERAL("bubbles");
+	cancelBubbleSymbol = SYMBOL_LITERAL("cancelBubble");
+	successSymbol = SYMBOL_LITERAL("success");
+	codeSymbol = SYMBOL_LITERAL("code");
+	errorSymbol = SYMBOL_LITERAL("error");
+
+	// The fields set on every event, in the order they are assigned.
+	eventTemplate = Persistent<ObjectTemplate>::New(ObjectTemplate::New());
+	eventTemplate->Set(typeSymbol, Undefined());
+	eventTemplate->Set(sourceSymbol, Undefined());
+	eventTemplate->Set(bubblesSymbol, False());
+	eventTemplate->Set(cancelBubbleSymbol, False());
+	eventTemplate->Set(nativeEventSymbol, True(), PropertyAttribute(DontEnum));
+
+	// emit() is installed without a signature so it also works for
+	// objects which only inherit from an emitter (see invoker.js).
+	constructorTemplate->PrototypeTemplate()->Set(emitSymbol,
+		FunctionTemplate::New(emitCallback),
+		static_cast<PropertyAttribute>(ReadOnly | DontEnum));
+}
+
+Local<Object> EventEmitter::newEventObject()
+{
+	return eventTemplate->NewInstance();
+}
+
+// Returns the event object passed to the listeners. Events created by
+// newEventObject() are used as is, for any other data a single event
+// object is created per dispatch and shared by all the listeners.
+static Local<Object> toEventObject(Handle<Object> emitter, Handle<Value> type, Handle<Value> data)
+{
+	if (data->IsObject()) {
+		Local<Object> object = data->ToObject();
+		if (object->Get(nativeEventSymbol)->IsTrue()) {
+			return object;
+		}
+	}
+
+	Local<Object> event = EventEmitter::newEventObject();
+	event->Set(EventEmitter::typeSymbol, type);
+	event->Set(EventEmitter::sourceSymbol, emitter);
+
+	// Copy any custom event data, it may override the type and source.
+	if (data->IsObject()) {
+		Local<Object> object = data->ToObject();
+		Local<Array> names = object->GetPropertyNames();
+		uint32_t length = names->Length();
+		for (uint32_t i = 0; i < length; ++i) {
+			Local<Value> name = names->Get(i);
+			event->Set(name, object->Get(name));
+		}
+
+		event->Set(EventEmitter::bubblesSymbol,
+			Boolean::New(event->Get(EventEmitter::bubblesSymbol)->BooleanValue()));
+		event->Set(EventEmitter::cancelBubbleSymbol,
+			Boolean::New(event->Get(EventEmitter::cancelBubbleSymbol)->BooleanValue()));
+	}
+
+	return event;
+}
+
+// Calls the listener of a handler added by addListener(). Returns false
+// if the listener threw an exception.
+static bool callHandler(Handle<Object> emitter, Handle<Object> handler, Handle<Value> type, Handle<Object> event, bool *handled)
+{
+	Local<Value> listener = handler->Get(listenerSymbol);
+	if (!listener->IsFunction()) {
+		if (V8Runtime::DBG) {
+			String::Utf8Value eventName(type);
+			LOGD(TAG, "handler for event '%s' is not a function and cannot be called.", *eventName);
+		}
+		return true;
+	}
+
+	// Listeners added on behalf of a view see the view proxy as the source.
+	Local<Value> source = event->Get(EventEmitter::sourceSymbol);
+	Local<Value> self = handler->Get(selfSymbol);
+	bool replaceSource = self->IsObject() && source->Equals(self->ToObject()->Get(viewSymbol));
+	if (replaceSource) {
+		event->Set(EventEmitter::sourceSymbol, self);
+	}
+
+	Handle<Value> args[] = { event };
+	Local<Value> result = Handle<Function>::Cast(listener)->Call(emitter, 1, args);
+	if (result.IsEmpty()) {
+		return false;
+	}
+
+	if (replaceSource) {
+		event->Set(EventEmitter::sourceSymbol, source);
+	}
+
+	*handled = true;
+	return true;
+}
+
+Handle<Value> EventEmitter::fireEvent(Handle<Object> emitter, Handle<Value> type, Handle<Value> data)
+{
+	HandleScope scope;
+	Local<Object> event = toEventObject(emitter, type, data);
+
+	if (emitter->Get(hasJavaListenerSymbol)->BooleanValue()) {
+		Local<Value> onEventFired = emitter->Get(onEventFiredSymbol);
+		if (onEventFired->IsFunction()) {
+			Handle<Value> args[] = { type, event };
+			if (Handle<Function>::Cast(onEventFired)->Call(emitter, 2, args).IsEmpty()) {
+				return Handle<Value>();
+			}
+		}
+	}
+
+	bool handled = false;
+	Local<Value> events = emitter->Get(eventsSymbol);
+	if (events->IsObject()) {
+		Local<Value> handlers = events->ToObject()->Get(type);
+
+		if (handlers->IsArray()) {
+			// addListener() and removeListener() replace the listener array
+			// instead of modifying it, so it is iterated without a copy.
+			Local<Array> listeners = Local<Array>::Cast(handlers);
+			uint32_t length = listeners->Length();
+			for (uint32_t i = 0; i < length; ++i) {
+				Local<Value> handler = listeners->Get(i);
+				if (!handler->IsObject()) continue;
+				if (!callHandler(emitter, handler->ToObject(), type, event, &handled)) {
+					return Handle<Value>();
+				}
+			}
+
+		} else if (handlers->IsObject()) {
+			if (!callHandler(emitter, handlers->ToObject(), type, event, &handled)) {
+				return Handle<Value>();
+			}
+		}
+	}
+
+	// Bubble the event to the parent view unless a listener cancelled it.
+	if (event->Get(bubblesSymbol)->BooleanValue() && !event->Get(cancelBubbleSymbol)->BooleanValue()) {
+		Handle<Value> result = fireEventToParent(emitter, type, event);
+		if (result.IsEmpty()) {
+			return Handle<Value>();
+		}
+		handled = result->BooleanValue() || handled;
+	}
+
+	return scope.Close(Boolean::New(handled));
+}
+
+Handle<Value> EventEmitter::fireEventToParent(Handle<Object> emitter, Handle<Value> type, Handle<Object> event)
+{
+	// Walk up through the native parent link when the emitter has one,
+	// this keeps bubbling through a view hierarchy inside V8.
+	if (constructorTemplate->HasInstance(emitter)) {
+		EventEmitter *nativeEmitter = NativeObject::Unwrap<EventEmitter>(emitter);
+		if (nativeEmitter && nativeEmitter->bubbleParentLinked_) {
+			if (nativeEmitter->bubbleParent_.IsEmpty()) {
+				return False();
+			}
+			Local<Object> parent = Local<Object>::New(nativeEmitter->bubbleParent_);
+			return fireEvent(parent, type, event);
+		}
+	}
+
+	Local<Value> fireEventToParent = emitter->Get(fireEventToParentSymbol);
+	if (!fireEventToParent->IsFunction()) {
+		return False();
+	}
+
+	Handle<Value> args[] = { type, event };
+	return Handle<Function>::Cast(fireEventToParent)->Call(emitter, 2, args);
+}
+
+void EventEmitter::setBubbleParent(Handle<Object> parent)
+{
+	unlinkBubbleParent();
+	bubbleParentLinked_ = true;
+
+	if (!parent.IsEmpty()) {
+		bubbleParent_ = Persistent<Object>::New(parent);
+		bubbleParent_.MakeWeak(this, bubbleParentCollected);
+	}
+}
+
+void EventEmitter::unlinkBubbleParent()
+{
+	bubbleParentLinked_ = false;
+
+	if (!bubbleParent_.IsEmpty()) {
+		bubbleParent_.Dispose();
+		bubbleParent_.Clear();
+	}
+}
+
+// The parent is no longer reachable from JavaScript. A new JavaScript object
+// may still be created for it by Java, so fall back to Java for bubbling.
+void EventEmitter::bubbleParentCollected(Persistent<Value> value, void *data)
+{
+	EventEmitter *emitter = static_cast<EventEmitter*>(data);
+	emitter->unlinkBubbleParent();
+}
+
+Handle<Value> EventEmitter::emitCallback(const Arguments& args)
+{
+	HandleScope scope;
+	if (args.Length() < 1) {
+		return False();
+	}
+
+	Handle<Value> data = args.Length() > 1 ? args[1] : Handle<Value>(Undefined());
+	Handle<Value> handled = fireEvent(args.This(), args[0], data);
+	if (handled.IsEmpty()) {
+		// Let the exception thrown by the listener propagate to the caller.
+		return handled;
+	}
+
+	return scope.Close(handled);
 }
 
 void EventEmitter::dispose()
@@ -58,44 +299,66 @@ void EventEmitter::dispose()
 
 	emitSymbol.Dispose();
 	emitSymbol = Persistent<String>();
+
+	nativeEventSymbol.Dispose();
+	nativeEventSymbol = Persistent<String>();
+
+	listenerSymbol.Dispose();
+	listenerSymbol = Persistent<String>();
+
+	selfSymbol.Dispose();
+	selfSymbol = Persistent<String>();
+
+	viewSymbol.Dispose();
+	viewSymbol = Persistent<String>();
+
+	hasJavaListenerSymbol.Dispose();
+	hasJavaListenerSymbol = Persistent<String>();
+
+	onEventFiredSymbol.Dispose();
+	onEventFiredSymbol = Persistent<String>();
+
+	fireEventToParentSymbol.Dispose();
+	fireEventToParentSymbol = Persistent<String>();
+
+	typeSymbol.Dispose();
+	typeSymbol = Persistent<String>();
+
+	sourceSymbol.Dispose();
+	sourceSymbol = Persistent<String>();
+
+	bubblesSymbol.Dispose();
+	bubblesSymbol = Persistent<String>();
+
+	cancelBubbleSymbol.Dispose();
+	cancelBubbleSymbol = Persistent<String>();
+
+	successSymbol.Dispose();
+	successSymbol = Persistent<String>();
+
+	codeSymbol.Dispose();
+	codeSymbol = Persistent<String>();
+
+	errorSymbol.Dispose();
+	errorSymbol = Persistent<String>();
+
+	eventTemplate.Dispose();
+	eventTemplate = Persistent<ObjectTemplate>();
 }
 
 bool EventEmitter::emit(Handle<String> event, int argc, Handle<Value> *argv)
 {
 	HandleScope scope;
-	Handle<Value> events_v = handle_->Get(eventsSymbol);
-	if (!events_v->IsObject()) return false;
-
-	Handle<Object> events = events_v->ToObject();
-
-	Handle<Value> listeners_v = events->Get(event);
 	TryCatch try_catch;
 
-	if (listeners_v->IsFunction()) {
-		// Optimized one-listener case
-		Handle<Function> listener = Handle<Function>::Cast(listeners_v);
-		listener->Call(handle_, argc, argv);
-		if (try_catch.HasCaught()) {
-			V8Util::fatalException(try_catch);
-			return false;
-		}
-	} else if (listeners_v->IsArray()) {
-		Handle<Array> listeners = Handle<Array>::Cast(listeners_v->ToObject()->Clone());
-		for (uint32_t i = 0; i < listeners->Length(); ++i) {
-			Handle<Value> listener_v = listeners->Get(i);
-			if (!listener_v->IsFunction()) continue;
-			Handle<Function> listener = Handle<Function>::Cast(listener_v);
-			listener->Call(handle_, argc, argv);
-			if (try_catch.HasCaught()) {
-				V8Util::fatalException(try_catch);
-				return false;
-			}
-		}
-	} else {
+	Handle<Value> data = argc > 0 ? argv[0] : Handle<Value>(Undefined());
+	Handle<Value> handled = fireEvent(handle_, event, data);
+	if (try_catch.HasCaught()) {
+		V8Util::fatalException(try_catch);
 		return false;
 	}
 
-	return true;
+	return handled->IsTrue();
 }
 
 } // namespace titanium
@@ -18,30 +18,61 @@ namespace titanium {
 
 // The base class for any object that emits events.
 // Provides an interface for listening to and firing events.
-// See events.js in the common runtime which implements most
-// of the logic for managing listeners and dispatching events.
+// Events are dispatched natively by emit(). See events.js in the
+// common runtime which implements the logic for managing listeners.
 class EventEmitter : public NativeObject
 {
 public:
 	static v8::Persistent<v8::String> emitSymbol;
 
+	// Fields of the event objects created for events fired from Java.
+	static v8::Persistent<v8::String> typeSymbol, sourceSymbol;
+	static v8::Persistent<v8::String> bubblesSymbol, cancelBubbleSymbol;
+	static v8::Persistent<v8::String> successSymbol, codeSymbol, errorSymbol;
+
 	static v8::Handle<v8::Value> eventEmitterConstructor(const v8::Arguments& args);
 	static void initTemplate();
 	static void dispose();
 
 	static v8::Persistent<v8::FunctionTemplate> constructorTemplate;
 
+	// Creates an event object with the standard fields already in place,
+	// so assigning them does not change the hidden class of the object.
+	// events.js passes these objects to the listeners without copying them.
+	static v8::Local<v8::Object> newEventObject();
+
+	// Dispatches an event to the listeners of the emitter and bubbles it
+	// to the parent unless a listener cancels it. Returns whether the event
+	// was handled, or an empty handle if a listener threw an exception.
+	static v8::Handle<v8::Value> fireEvent(v8::Handle<v8::Object> emitter, v8::Handle<v8::Value> type, v8::Handle<v8::Value> data);
+
 	bool emit(v8::Handle<v8::String> event, int argc, v8::Handle<v8::Value> *argv);
 
+	// Links the emitter to the parent its events bubble to, an empty parent
+	// stops bubbling. The parent is held weakly. Unlinked emitters, and those
+	// whose parent was collected, bubble through the Java _fireEventToParent().
+	void setBubbleParent(v8::Handle<v8::Object> parent);
+	void unlinkBubbleParent();
+
 protected:
 	EventEmitter()
 		: NativeObject()
+		, bubbleParentLinked_(false)
 	{
 	}
 
 	virtual ~EventEmitter()
 	{
+		unlinkBubbleParent();
 	}
+
+private:
+	static v8::Handle<v8::Value> emitCallback(const v8::Arguments& args);
+	static v8::Handle<v8::Value> fireEventToParent(v8::Handle<v8::Object> emitter, v8::Handle<v8::Value> type, v8::Handle<v8::Object> event);
+	static void bubbleParentCollected(v8::Persistent<v8::Value> value, void *data);
+
+	v8::Persistent<v8::Object> bubbleParent_;
+	bool bubbleParentLinked_;
 };
 
 }
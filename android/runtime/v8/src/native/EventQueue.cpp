@@ -0,0 +1,292 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <jni.h>
+#include <pthread.h>
+#include <v8.h>
+
+#include "AndroidUtil.h"
+#include "EventCoalescer.h"
+#include "EventQueue.h"
+#include "JNIUtil.h"
+
+#define TAG "EventQueue"
+
+// Above this depth a new coalescable event replaces the pending event of
+// the same proxy and type, or is dropped if there is none. Events which
+// are never coalesced are always queued.
+#define MAX_DEPTH 1024
+
+// Name of the array of earlier data added to accumulated events.
+#define HISTORY_KEY "history"
+
+using namespace v8;
+
+namespace titanium {
+
+struct QueuedEvent
+{
+	QueuedEvent *next;
+	jobject proxy;
+	jstring type;
+	jobject data;
+	int coalescing;
+	std::string typeName; // only set for coalescable events
+	std::vector<jobject> history; // data of accumulated events, newest first
+};
+
+// Producers push on the head, the KrollRuntime thread takes the whole list.
+static QueuedEvent * volatile head = NULL;
+
+// Held while a producer walks the pending list of a full queue, and while
+// the KrollRuntime thread takes the list, so the walked entries stay alive.
+// Pushes only prepend to the list and do not take it.
+static pthread_mutex_t listMutex = PTHREAD_MUTEX_INITIALIZER;
+static EventQueue::Stats stats = { 0, 0, 0, 0, 0, 0 };
+
+static void freeEntry(JNIEnv *env, QueuedEvent *entry)
+{
+	env->DeleteGlobalRef(entry->proxy);
+	env->DeleteGlobalRef(entry->type);
+	if (entry->data) {
+		env->DeleteGlobalRef(entry->data);
+	}
+	for (std::vector<jobject>::iterator i = entry->history.begin(); i != entry->history.end(); ++i) {
+		if (*i) {
+			env->DeleteGlobalRef(*i);
+		}
+	}
+	delete entry;
+}
+
+static QueuedEvent* takeAll()
+{
+	pthread_mutex_lock(&listMutex);
+	QueuedEvent *list;
+	do {
+		list = head;
+	} while (list && !__sync_bool_compare_and_swap(&head, list, (QueuedEvent *) NULL));
+	pthread_mutex_unlock(&listMutex);
+	return list;
+}
+
+static void addHistory(JNIEnv *env, QueuedEvent *entry);
+
+// Coalesces entries holding global references, see EventCoalescer.
+class EntryPolicy
+{
+public:
+	EntryPolicy(JNIEnv *env)
+		: env(env)
+	{
+	}
+
+	bool sameTarget(QueuedEvent *a, QueuedEvent *b)
+	{
+		return a->typeName == b->typeName && env->IsSameObject(a->proxy, b->proxy);
+	}
+
+	void accumulate(QueuedEvent *kept, QueuedEvent *earlier)
+	{
+		kept->history.push_back(earlier->data);
+		earlier->data = NULL;
+	}
+
+	void supersede(QueuedEvent *pending, QueuedEvent *incoming)
+	{
+		if (pending->coalescing == EventQueue::COALESCE_ACCUMULATE) {
+			// the pending data is now the newest of the history
+			pending->history.insert(pending->history.begin(), pending->data);
+		} else if (pending->data) {
+			env->DeleteGlobalRef(pending->data);
+		}
+		pending->data = incoming->data;
+		incoming->data = NULL;
+	}
+
+	void finish(QueuedEvent *kept)
+	{
+		if (!kept->history.empty()) {
+			addHistory(env, kept);
+		}
+	}
+
+	void release(QueuedEvent *entry)
+	{
+		freeEntry(env, entry);
+	}
+
+private:
+	JNIEnv *env;
+};
+
+bool EventQueue::post(JNIEnv *env, jobject proxy, jstring type, jobject data, int coalescing)
+{
+	int32_t depth = __sync_add_and_fetch(&stats.depth, 1);
+	bool full = coalescing != COALESCE_NONE && depth > MAX_DEPTH;
+
+	if (!full) {
+		int32_t maxDepth = stats.maxDepth;
+		while (depth > maxDepth && !__sync_bool_compare_and_swap(&stats.maxDepth, maxDepth, depth)) {
+			maxDepth = stats.maxDepth;
+		}
+	}
+	__sync_add_and_fetch(&stats.posted, 1);
+
+	QueuedEvent *entry = new QueuedEvent();
+	entry->next = NULL;
+	entry->proxy = env->NewGlobalRef(proxy);
+	entry->type = (jstring) env->NewGlobalRef(type);
+	entry->data = data ? env->NewGlobalRef(data) : NULL;
+	entry->coalescing = coalescing;
+
+	if (coalescing != COALESCE_NONE) {
+		const char *chars = env->GetStringUTFChars(type, NULL);
+		entry->typeName = chars;
+		env->ReleaseStringUTFChars(type, chars);
+	}
+
+	if (full) {
+		// The latest state wins: the pending event of this proxy and type
+		// takes the new data and keeps its place in the queue.
+		__sync_sub_and_fetch(&stats.depth, 1);
+
+		EntryPolicy policy(env);
+		pthread_mutex_lock(&listMutex);
+		bool superseded = EventCoalescer::supersede(head, entry, policy);
+		pthread_mutex_unlock(&listMutex);
+
+		__sync_add_and_fetch(superseded ? &stats.coalesced : &stats.dropped, 1);
+		freeEntry(env, entry);
+		return false;
+	}
+
+	QueuedEvent *first;
+	do {
+		first = head;
+		entry->next = first;
+	} while (!__sync_bool_compare_and_swap(&head, first, entry));
+
+	return first == NULL;
+}
+
+// Adds the data of the accumulated events to the event kept for them,
+// oldest first. Data other than a HashMap only keeps the latest event.
+static void addHistory(JNIEnv *env, QueuedEvent *entry)
+{
+	if (!entry->data || !env->IsInstanceOf(entry->data, JNIUtil::hashMapClass)) {
+		return;
+	}
+
+	jsize length = entry->history.size();
+	jobjectArray history = env->NewObjectArray(length, JNIUtil::objectClass, NULL);
+	if (!history) {
+		env->ExceptionClear();
+		return;
+	}
+
+	for (jsize i = 0; i < length; ++i) {
+		env->SetObjectArrayElement(history, i, entry->history[length - i - 1]);
+	}
+
+	jstring key = env->NewStringUTF(HISTORY_KEY);
+	jobject previous = env->CallObjectMethod(entry->data, JNIUtil::hashMapPutMethod, key, history);
+	if (env->ExceptionCheck()) {
+		env->ExceptionDescribe();
+		env->ExceptionClear();
+	}
+
+	env->DeleteLocalRef(previous);
+	env->DeleteLocalRef(key);
+	env->DeleteLocalRef(history);
+}
+
+int EventQueue::drain(JNIEnv *env)
+{
+	QueuedEvent *list = takeAll();
+	if (!list) {
+		return 0;
+	}
+
+	// Entries are pushed in front of each other, restore the posting order.
+	std::vector<QueuedEvent*> entries;
+	for (QueuedEvent *entry = list; entry; entry = entry->next) {
+		entries.push_back(entry);
+	}
+	std::reverse(entries.begin(), entries.end());
+	__sync_sub_and_fetch(&stats.depth, (int32_t) entries.size());
+
+	EntryPolicy policy(env);
+	__sync_add_and_fetch(&stats.coalesced, EventCoalescer::coalesce(entries, policy));
+
+	int dispatched = 0;
+	for (std::vector<QueuedEvent*>::iterator i = entries.begin(); i != entries.end(); ++i) {
+		QueuedEvent *entry = *i;
+		if (!entry) {
+			continue;
+		}
+
+		env->CallBooleanMethod(entry->proxy, JNIUtil::krollProxyDoFireEventMethod, entry->type, entry->data);
+		if (env->ExceptionCheck()) {
+			env->ExceptionDescribe();
+			env->ExceptionClear();
+		}
+
+		freeEntry(env, entry);
+		++dispatched;
+	}
+
+	__sync_add_and_fetch(&stats.dispatched, dispatched);
+	return dispatched;
+}
+
+void EventQueue::getStats(Stats *out)
+{
+	out->depth = stats.depth;
+	out->maxDepth = stats.maxDepth;
+	out->posted = stats.posted;
+	out->dispatched = stats.dispatched;
+	out->coalesced = stats.coalesced;
+	out->dropped = stats.dropped;
+}
+
+Handle<Value> EventQueue::getEventQueueStats(const Arguments& args)
+{
+	HandleScope scope;
+	Stats current;
+	getStats(&current);
+
+	Local<Object> result = Object::New();
+	result->Set(String::NewSymbol("depth"), Integer::New(current.depth));
+	result->Set(String::NewSymbol("maxDepth"), Integer::New(current.maxDepth));
+	result->Set(String::NewSymbol("posted"), Integer::NewFromUnsigned(current.posted));
+	result->Set(String::NewSymbol("dispatched"), Integer::NewFromUnsigned(current.dispatched));
+	result->Set(String::NewSymbol("coalesced"), Integer::NewFromUnsigned(current.coalesced));
+	result->Set(String::NewSymbol("dropped"), Integer::NewFromUnsigned(current.dropped));
+
+	return scope.Close(result);
+}
+
+void EventQueue::dispose(JNIEnv *env)
+{
+	QueuedEvent *list = takeAll();
+	while (list) {
+		QueuedEvent *next = list->next;
+		freeEntry(env, list);
+		list = next;
+	}
+
+	LOGD(TAG, "posted=%u dispatched=%u coalesced=%u dropped=%u maxDepth=%d",
+		stats.posted, stats.dispatched, stats.coalesced, stats.dropped, stats.maxDepth);
+
+	stats.depth = stats.maxDepth = 0;
+	stats.posted = stats.dispatched = stats.coalesced = stats.dropped = 0;
+}
+
+} // namespace titanium
@@ -0,0 +1,69 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#include <jni.h>
+#include <stdint.h>
+#include <v8.h>
+
+#include "EventCoalescer.h"
+
+namespace titanium {
+
+// Events fired asynchronously by Java proxies. Producers post from any
+// thread without taking a lock, and the KrollRuntime thread dispatches
+// all the pending events at once. While they wait, high frequency events
+// are coalesced per proxy and event type, so a JavaScript thread that
+// falls behind receives the latest state instead of an unbounded backlog.
+//
+// Only the post to an empty queue schedules a drain, and the events posted
+// until it runs are dispatched together. An event posted while a drain is
+// pending therefore overtakes the Handler messages sent to the KrollRuntime
+// thread in between, ex: a property change or a fireSyncEvent(). Events
+// keep their order among themselves, apart from the coalesced ones.
+class EventQueue
+{
+public:
+	enum Coalescing
+	{
+		COALESCE_NONE = EventCoalescer::NONE,
+		COALESCE_LATEST = EventCoalescer::LATEST,
+		COALESCE_ACCUMULATE = EventCoalescer::ACCUMULATE
+	};
+
+	struct Stats
+	{
+		int32_t depth;       // events waiting to be dispatched
+		int32_t maxDepth;    // highest depth reached
+		uint32_t posted;
+		uint32_t dispatched;
+		uint32_t coalesced;  // events merged into another event
+		uint32_t dropped;    // coalescable events discarded on a full queue,
+		                     // with no pending event to merge into
+	};
+
+	// Posts an event fired by the proxy, can be called from any thread.
+	// Returns true if the queue was empty, the caller then schedules
+	// a drain() on the KrollRuntime thread.
+	static bool post(JNIEnv *env, jobject proxy, jstring type, jobject data, int coalescing);
+
+	// Dispatches the pending events on the KrollRuntime thread. Events
+	// posted by the listeners wait for the next drain.
+	// Returns the number of events dispatched.
+	static int drain(JNIEnv *env);
+
+	static void getStats(Stats *stats);
+	static v8::Handle<v8::Value> getEventQueueStats(const v8::Arguments& args);
+
+	// Discards the pending events and resets the counters.
+	static void dispose(JNIEnv *env);
+};
+
+} // namespace titanium
+
+#endif
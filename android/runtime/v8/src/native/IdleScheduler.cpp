@@ -0,0 +1,166 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#include <string.h>
+#include <time.h>
+#include <v8.h>
+
+#include "AndroidUtil.h"
+#include "IdleScheduler.h"
+
+#define TAG "IdleScheduler"
+
+// Hint asking V8 for a complete idle round, see V8::IdleNotification.
+#define FULL_IDLE_HINT 1000
+
+// A round overruns when it ends later than this fraction
+// of the budget past its deadline.
+#define OVERRUN_DIVISOR 2
+
+// Limits for the back off applied after an overrun.
+#define MAX_HINT_DIVISOR 16
+#define MAX_BACKOFF_PERIODS 32
+
+using namespace v8;
+
+namespace titanium {
+
+static IdleScheduler::Stats stats;
+
+// Used heap size when V8 last reported it had no idle work left.
+static bool idleDone = false;
+static size_t lastUsedHeap = 0;
+
+// The hint passed to V8 is the budget divided by hintDivisor.
+// Both the divisor and the number of skipped periods double
+// on every overrun and are reduced again once rounds fit.
+static int hintDivisor = 1;
+static int backoffPeriods = 0;
+static int skipPeriods = 0;
+
+static uint64_t currentTimeUs()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+static size_t usedHeapSize()
+{
+	HeapStatistics heapStats;
+	V8::GetHeapStatistics(&heapStats);
+	return heapStats.used_heap_size();
+}
+
+static bool notifyIdle(int hint)
+{
+	size_t usedBefore = usedHeapSize();
+	uint64_t start = currentTimeUs();
+
+	bool done = V8::IdleNotification(hint);
+
+	stats.timeUs += currentTimeUs() - start;
+	stats.calls++;
+
+	size_t usedAfter = usedHeapSize();
+	if (usedAfter < usedBefore) {
+		stats.bytesFreed += usedBefore - usedAfter;
+	}
+
+	if (done) {
+		idleDone = true;
+		lastUsedHeap = usedAfter;
+		stats.completed++;
+	} else {
+		idleDone = false;
+	}
+
+	return done;
+}
+
+bool IdleScheduler::idle(int budgetMs, bool force)
+{
+	if (!force) {
+		// Backing off, no continuation is wanted until a later idle period.
+		if (skipPeriods > 0) {
+			skipPeriods--;
+			stats.skipped++;
+			return true;
+		}
+
+		// Nothing has been allocated since V8 finished its last round.
+		if (idleDone && usedHeapSize() <= lastUsedHeap) {
+			stats.skipped++;
+			return true;
+		}
+	}
+
+	int hint = budgetMs / hintDivisor;
+	if (hint < 1) {
+		hint = 1;
+	}
+
+	uint64_t budgetUs = (uint64_t) budgetMs * 1000;
+	uint64_t deadline = currentTimeUs() + budgetUs;
+	uint64_t now;
+	bool done;
+	do {
+		done = notifyIdle(hint);
+		now = currentTimeUs();
+	} while (!done && now < deadline);
+
+	bool overrun = now > deadline + budgetUs / OVERRUN_DIVISOR;
+	if (overrun) {
+		// V8 did more work than the budget allows, the thread is
+		// likely busy. Ask for less work and skip a few periods.
+		if (hintDivisor < MAX_HINT_DIVISOR) {
+			hintDivisor *= 2;
+		}
+		backoffPeriods = backoffPeriods == 0 ? 1 : backoffPeriods * 2;
+		if (backoffPeriods > MAX_BACKOFF_PERIODS) {
+			backoffPeriods = MAX_BACKOFF_PERIODS;
+		}
+		skipPeriods = backoffPeriods;
+	} else {
+		backoffPeriods = 0;
+		if (hintDivisor > 1) {
+			hintDivisor /= 2;
+		}
+	}
+
+	// The work only continues in the next frame while V8 has more
+	// of it and this round fit in its budget.
+	return done || overrun;
+}
+
+void IdleScheduler::collectAll()
+{
+	while (!notifyIdle(FULL_IDLE_HINT));
+}
+
+void IdleScheduler::getStats(Stats *out)
+{
+	*out = stats;
+}
+
+void IdleScheduler::logStats()
+{
+	LOGD(TAG, "Idle work: calls=%u skipped=%u completed=%u time=%llums freed=%lluk",
+		stats.calls, stats.skipped, stats.completed,
+		(unsigned long long) (stats.timeUs / 1000), (unsigned long long) (stats.bytesFreed / 1024));
+}
+
+void IdleScheduler::reset()
+{
+	memset(&stats, 0, sizeof(stats));
+	idleDone = false;
+	lastUsedHeap = 0;
+	hintDivisor = 1;
+	backoffPeriods = 0;
+	skipPeriods = 0;
+}
+
+} // namespace titanium
@@ -0,0 +1,49 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#ifndef IDLE_SCHEDULER_H
+#define IDLE_SCHEDULER_H
+
+#include <stdint.h>
+
+namespace titanium {
+
+// Spreads the V8 idle-time GC work over the idle periods of
+// the KrollRuntime thread. Each idle period is given a time budget
+// and V8 is asked for small increments of work until the budget is
+// spent. Idle periods are skipped when nothing was allocated since V8
+// finished its last round, and after a round ran over its budget.
+class IdleScheduler
+{
+public:
+	struct Stats
+	{
+		uint32_t calls;      // calls to V8::IdleNotification
+		uint32_t skipped;    // idle periods with no work or backing off
+		uint32_t completed;  // rounds after which V8 had no work left
+		uint64_t timeUs;     // time spent in V8::IdleNotification
+		uint64_t bytesFreed; // used heap released by idle work
+	};
+
+	// Run idle work for at most budgetMs milliseconds. When force is
+	// true the work runs even if the scheduler would skip this period.
+	// Returns false when V8 has idle work left and the round fit in its
+	// budget, the caller then continues the work in the next frame.
+	// Returns true once V8 is done, and while the scheduler skips idle
+	// periods or backs off after an overrun.
+	static bool idle(int budgetMs, bool force);
+
+	// Run idle work until V8 is done. Used when disposing the runtime.
+	static void collectAll();
+
+	static void getStats(Stats *stats);
+	static void logStats();
+	static void reset();
+};
+
+} // namespace titanium
+
+#endif
@@ -5,6 +5,7 @@
  * Please see the LICENSE included with this distribution for details.
  */
 #include <jni.h>
+#include <pthread.h>
 #include <stdio.h>
 
 #include "JNIUtil.h"
@@ -42,10 +43,14 @@ jclass JNIUtil::dateClass = NULL;
 jclass JNIUtil::setClass = NULL;
 jclass JNIUtil::outOfMemoryError = NULL;
 jclass JNIUtil::nullPointerException = NULL;
+jclass JNIUtil::systemClass = NULL;
+jclass JNIUtil::androidLogClass = NULL;
+jclass JNIUtil::weakReferenceClass = NULL;
 jclass JNIUtil::throwableClass = NULL;
 
 jclass JNIUtil::v8ObjectClass = NULL;
 jclass JNIUtil::v8FunctionClass = NULL;
+jclass JNIUtil::v8RuntimeClass = NULL;
 jclass JNIUtil::krollRuntimeClass = NULL;
 jclass JNIUtil::krollInvocationClass = NULL;
 jclass JNIUtil::krollExceptionClass = NULL;
@@ -54,7 +59,6 @@ jclass JNIUtil::krollProxyClass = NULL;
 jclass JNIUtil::krollAssetHelperClass = NULL;
 jclass JNIUtil::krollLoggingClass = NULL;
 jclass JNIUtil::krollDictClass = NULL;
-jclass JNIUtil::referenceTableClass = NULL;
 
 jmethodID JNIUtil::classGetNameMethod = NULL;
 jmethodID JNIUtil::arrayListInitMethod = NULL;
@@ -80,30 +84,34 @@ jmethodID JNIUtil::booleanBooleanValueMethod = NULL;
 jmethodID JNIUtil::longInitMethod = NULL;
 jmethodID JNIUtil::numberDoubleValueMethod = NULL;
 jmethodID JNIUtil::throwableGetMessageMethod = NULL;
+jmethodID JNIUtil::systemIdentityHashCodeMethod = NULL;
+jmethodID JNIUtil::androidLogGetStackTraceStringMethod = NULL;
+jmethodID JNIUtil::weakReferenceInitMethod = NULL;
+jmethodID JNIUtil::weakReferenceGetMethod = NULL;
 
 jfieldID JNIUtil::v8ObjectPtrField = NULL;
 jmethodID JNIUtil::v8ObjectInitMethod = NULL;
 jmethodID JNIUtil::v8FunctionInitMethod = NULL;
-
-jmethodID JNIUtil::referenceTableCreateReferenceMethod = NULL;
-jmethodID JNIUtil::referenceTableDestroyReferenceMethod = NULL;
-jmethodID JNIUtil::referenceTableMakeWeakReferenceMethod = NULL;
-jmethodID JNIUtil::referenceTableClearWeakReferenceMethod = NULL;
-jmethodID JNIUtil::referenceTableGetReferenceMethod = NULL;
+jmethodID JNIUtil::v8RuntimeScheduleAsyncMethodDrainMethod = NULL;
 
 jint JNIUtil::krollRuntimeDontIntercept = -1;
+jint JNIUtil::krollObjectListenerBitmapBits = 0;
 jmethodID JNIUtil::krollInvocationInitMethod = NULL;
 jmethodID JNIUtil::krollExceptionInitMethod = NULL;
 jmethodID JNIUtil::krollObjectSetHasListenersForEventTypeMethod = NULL;
 jmethodID JNIUtil::krollObjectOnEventFiredMethod = NULL;
+jmethodID JNIUtil::krollObjectGetEventTypeIdMethod = NULL;
+jmethodID JNIUtil::krollObjectGetListenerBitmapMethod = NULL;
 jmethodID JNIUtil::krollProxyCreateProxyMethod = NULL;
 jmethodID JNIUtil::krollProxyCreateDeprecatedProxyMethod = NULL;
 jfieldID JNIUtil::krollProxyKrollObjectField = NULL;
 jfieldID JNIUtil::krollProxyModelListenerField = NULL;
+jfieldID JNIUtil::krollProxyExternalMemorySizeField = NULL;
 jmethodID JNIUtil::krollProxySetIndexedPropertyMethod = NULL;
 jmethodID JNIUtil::krollProxyGetIndexedPropertyMethod = NULL;
 jmethodID JNIUtil::krollProxyOnPropertyChangedMethod = NULL;
 jmethodID JNIUtil::krollProxyOnPropertiesChangedMethod = NULL;
+jmethodID JNIUtil::krollProxyDoFireEventMethod = NULL;
 jmethodID JNIUtil::krollAssetHelperReadAssetMethod = NULL;
 jmethodID JNIUtil::krollLoggingLogWithDefaultLoggerMethod = NULL;
 
@@ -111,14 +119,60 @@ jmethodID JNIUtil::krollRuntimeDispatchExceptionMethod = NULL;
 
 JNIEnv* JNIScope::current = NULL;
 
+// The JNIEnv of each thread is looked up once and kept in thread-local
+// storage. Threads attached here are detached when they exit, threads
+// already known to the VM (Java threads) are left alone.
+struct ThreadEnv
+{
+	JNIEnv *env;
+	bool attached;
+};
+
+static pthread_key_t threadEnvKey;
+static pthread_once_t threadEnvKeyOnce = PTHREAD_ONCE_INIT;
+
+static void releaseThreadEnv(void *value)
+{
+	ThreadEnv *threadEnv = static_cast<ThreadEnv*>(value);
+	if (threadEnv->attached) {
+		JNIUtil::javaVm->DetachCurrentThread();
+	}
+	delete threadEnv;
+}
+
+static void createThreadEnvKey()
+{
+	pthread_key_create(&threadEnvKey, releaseThreadEnv);
+}
+
 /* static */
 JNIEnv* JNIUtil::getJNIEnv()
 {
+	pthread_once(&threadEnvKeyOnce, createThreadEnvKey);
+
+	ThreadEnv *threadEnv = static_cast<ThreadEnv*>(pthread_getspecific(threadEnvKey));
+	if (threadEnv) {
+		return threadEnv->env;
+	}
+
 	JNIEnv *env;
+	bool attached = false;
 	int status = javaVm->GetEnv((void **) &env, JNI_VERSION_1_4);
-	if (status < 0) {
+	if (status == JNI_EDETACHED) {
+		if (javaVm->AttachCurrentThread(&env, NULL) != JNI_OK) {
+			LOGE(TAG, "Unable to attach the current thread to the VM");
+			return NULL;
+		}
+		attached = true;
+	} else if (status != JNI_OK) {
 		return NULL;
 	}
+
+	threadEnv = new ThreadEnv();
+	threadEnv->env = env;
+	threadEnv->attached = attached;
+	pthread_setspecific(threadEnvKey, threadEnv);
+
 	return env;
 }
 
@@ -233,6 +287,33 @@ jfieldID JNIUtil::getFieldID(jclass javaClass, const char *fieldName, const char
 	return javaFieldID;
 }
 
+// Resolves a table of instance method IDs. The first missing
+// method is logged and aborts the process.
+void JNIUtil::getMethodIDs(jclass javaClass, const MethodDescriptor *descriptors, jmethodID *methodIDs, int count)
+{
+	JNIEnv *env = JNIScope::getEnv();
+	if (!env) {
+		LOGE(TAG, "Couldn't initialize JNIEnv");
+		abort();
+	}
+
+	for (int i = 0; i < count; ++i) {
+		methodIDs[i] = env->GetMethodID(javaClass, descriptors[i].name, descriptors[i].signature);
+		if (methodIDs[i]) {
+			continue;
+		}
+
+		// The generated binding does not match its Java class, its
+		// methods can't be called. Fail now instead of on first use.
+		env->ExceptionClear();
+		jstring javaClassName = getClassName(javaClass);
+		const char *className = javaClassName ? env->GetStringUTFChars(javaClassName, NULL) : NULL;
+		LOGE(TAG, "Couldn't find proxy method %s.%s%s", className ? className : "<unknown class>",
+			descriptors[i].name, descriptors[i].signature);
+		abort();
+	}
+}
+
 jstring JNIUtil::getClassName(jclass javaClass)
 {
 	JNIEnv *env = JNIScope::getEnv();
@@ -290,9 +371,13 @@ void JNIUtil::initCache()
 	outOfMemoryError = findClass("java/lang/OutOfMemoryError");
 	nullPointerException = findClass("java/lang/NullPointerException");
 	throwableClass = findClass("java/lang/Throwable");
+	systemClass = findClass("java/lang/System");
+	androidLogClass = findClass("android/util/Log");
+	weakReferenceClass = findClass("java/lang/ref/WeakReference");
 
 	v8ObjectClass = findClass("org/appcelerator/kroll/runtime/v8/V8Object");
 	v8FunctionClass = findClass("org/appcelerator/kroll/runtime/v8/V8Function");
+	v8RuntimeClass = findClass("org/appcelerator/kroll/runtime/v8/V8Runtime");
 	krollRuntimeClass = findClass("org/appcelerator/kroll/KrollRuntime");
 	krollInvocationClass = findClass("org/appcelerator/kroll/KrollInvocation");
 	krollObjectClass = findClass("org/appcelerator/kroll/KrollObject");
@@ -301,7 +386,6 @@ void JNIUtil::initCache()
 	krollLoggingClass = findClass("org/appcelerator/kroll/KrollLogging");
 	krollExceptionClass = findClass("org/appcelerator/kroll/KrollException");
 	krollDictClass = findClass("org/appcelerator/kroll/KrollDict");
-	referenceTableClass = findClass("org/appcelerator/kroll/runtime/v8/ReferenceTable");
 
 	classGetNameMethod = getMethodID(classClass, "getName", "()Ljava/lang/String;", false);
 	arrayListInitMethod = getMethodID(arrayListClass, "<init>", "()V", false);
@@ -327,29 +411,34 @@ void JNIUtil::initCache()
 	longInitMethod = getMethodID(longClass, "<init>", "(J)V", false);
 	numberDoubleValueMethod = getMethodID(numberClass, "doubleValue", "()D", false);
 	throwableGetMessageMethod = getMethodID(throwableClass, "getMessage", "()Ljava/lang/String;", false);
+	systemIdentityHashCodeMethod = getMethodID(systemClass, "identityHashCode", "(Ljava/lang/Object;)I", true);
+	androidLogGetStackTraceStringMethod = getMethodID(androidLogClass, "getStackTraceString",
+		"(Ljava/lang/Throwable;)Ljava/lang/String;", true);
+	weakReferenceInitMethod = getMethodID(weakReferenceClass, "<init>", "(Ljava/lang/Object;)V", false);
+	weakReferenceGetMethod = getMethodID(weakReferenceClass, "get", "()Ljava/lang/Object;", false);
 
 	v8ObjectPtrField = getFieldID(v8ObjectClass, "ptr", "J");
 	v8ObjectInitMethod = getMethodID(v8ObjectClass, "<init>", "(J)V", false);
 	v8FunctionInitMethod = getMethodID(v8FunctionClass, "<init>", "(J)V", false);
+	v8RuntimeScheduleAsyncMethodDrainMethod = getMethodID(v8RuntimeClass, "scheduleAsyncMethodDrain", "()V", true);
 
 	krollDictInitMethod = getMethodID(krollDictClass, "<init>", "(I)V", false);
 	krollDictPutMethod = getMethodID(krollDictClass, "put", "(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;",
 			false);
 
-	referenceTableCreateReferenceMethod = getMethodID(referenceTableClass, "createReference", "(Ljava/lang/Object;)I", true);
-	referenceTableDestroyReferenceMethod = getMethodID(referenceTableClass, "destroyReference", "(I)V", true);
-	referenceTableMakeWeakReferenceMethod = getMethodID(referenceTableClass, "makeWeakReference", "(I)V", true);
-	referenceTableClearWeakReferenceMethod = getMethodID(referenceTableClass, "clearWeakReference", "(I)Ljava/lang/Object;", true);
-	referenceTableGetReferenceMethod = getMethodID(referenceTableClass, "getReference", "(I)Ljava/lang/Object;", true);
-
 	jfieldID dontInterceptField = env->GetStaticFieldID(krollRuntimeClass, "DONT_INTERCEPT", "I");
 	krollRuntimeDontIntercept = env->GetStaticIntField(krollRuntimeClass, dontInterceptField);
 
+	jfieldID listenerBitmapBitsField = env->GetStaticFieldID(krollObjectClass, "LISTENER_BITMAP_BITS", "I");
+	krollObjectListenerBitmapBits = env->GetStaticIntField(krollObjectClass, listenerBitmapBitsField);
+
 	krollInvocationInitMethod = getMethodID(krollInvocationClass, "<init>", "(Ljava/lang/String;)V", false);
 	krollExceptionInitMethod = getMethodID(krollExceptionClass, "<init>", "(Ljava/lang/String;Ljava/lang/String;)V", false);
 	krollObjectSetHasListenersForEventTypeMethod = getMethodID(krollObjectClass, "setHasListenersForEventType",
 		"(Ljava/lang/String;Z)V");
 	krollObjectOnEventFiredMethod = getMethodID(krollObjectClass, "onEventFired", "(Ljava/lang/String;Ljava/lang/Object;)V");
+	krollObjectGetEventTypeIdMethod = getMethodID(krollObjectClass, "getEventTypeId", "(Ljava/lang/String;)I", true);
+	krollObjectGetListenerBitmapMethod = getMethodID(krollObjectClass, "getListenerBitmap", "()Ljava/nio/ByteBuffer;");
 
 	const char *createProxySignature = "(Ljava/lang/Class;Lorg/appcelerator/kroll/KrollObject;[Ljava/lang/Object;Ljava/lang/String;)Lorg/appcelerator/kroll/KrollProxy;";
 	krollProxyCreateProxyMethod = getMethodID(krollProxyClass, "createProxy", createProxySignature, true);
@@ -357,12 +446,15 @@ void JNIUtil::initCache()
 
 	krollProxyKrollObjectField = getFieldID(krollProxyClass, "krollObject", "Lorg/appcelerator/kroll/KrollObject;");
 	krollProxyModelListenerField = getFieldID(krollProxyClass, "modelListener", "Lorg/appcelerator/kroll/KrollProxyListener;");
+	krollProxyExternalMemorySizeField = getFieldID(krollProxyClass, "externalMemorySize", "J");
 	krollProxySetIndexedPropertyMethod = getMethodID(krollProxyClass, "setIndexedProperty", "(ILjava/lang/Object;)V");
 	krollProxyGetIndexedPropertyMethod = getMethodID(krollProxyClass, "getIndexedProperty", "(I)Ljava/lang/Object;");
 	krollProxyOnPropertyChangedMethod = getMethodID(krollProxyClass, "onPropertyChanged",
 		"(Ljava/lang/String;Ljava/lang/Object;)V");
 	krollProxyOnPropertiesChangedMethod = getMethodID(krollProxyClass, "onPropertiesChanged",
 		"([[Ljava/lang/Object;)V", false);
+	krollProxyDoFireEventMethod = getMethodID(krollProxyClass, "doFireEvent",
+		"(Ljava/lang/String;Ljava/lang/Object;)Z", false);
 
 	krollRuntimeDispatchExceptionMethod = getMethodID(krollRuntimeClass, "dispatchException", "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;ILjava/lang/String;I)V",true);
 	krollAssetHelperReadAssetMethod = getMethodID(krollAssetHelperClass, "readAsset", "(Ljava/lang/String;)Ljava/lang/String;", true);
@@ -19,13 +19,29 @@ namespace titanium {
 class JNIUtil
 {
 public:
+	// Name and signature of a Java method, used to resolve
+	// the method ID tables of the generated proxy bindings.
+	struct MethodDescriptor
+	{
+		const char *name;
+		const char *signature;
+	};
+
 	static JavaVM *javaVm;
+
+	// Returns the JNIEnv of the current thread, cached per thread after
+	// the first call. A native thread is attached to the VM on first use
+	// and detached when it exits. Safe on any thread, unlike
+	// JNIScope::getEnv() which is meant for the runtime thread.
 	static JNIEnv* getJNIEnv();
 	static void terminateVM();
 	static void initCache();
 	static jclass findClass(const char *className);
 	static jmethodID getMethodID(jclass javaClass, const char *methodName, const char *signature, bool isStatic = false);
 	static jfieldID getFieldID(jclass javaClass, const char *fieldName, const char *signature);
+	// Resolves every method of a generated proxy binding. Aborts with the
+	// name of the first method which can't be found in the class.
+	static void getMethodIDs(jclass javaClass, const MethodDescriptor *descriptors, jmethodID *methodIDs, int count);
 	static jstring getClassName(jclass javaClass);
 	static void logClassName(const char *format, jclass javaClass, bool errorLevel = false);
 
@@ -64,10 +80,14 @@ public:
 	static jclass outOfMemoryError;
 	static jclass throwableClass;
 	static jclass nullPointerException;
+	static jclass systemClass;
+	static jclass androidLogClass;
+	static jclass weakReferenceClass;
 
 	// Titanium classes
 	static jclass v8ObjectClass;
 	static jclass v8FunctionClass;
+	static jclass v8RuntimeClass;
 	static jclass krollRuntimeClass;
 	static jclass krollInvocationClass;
 	static jclass krollExceptionClass;
@@ -77,7 +97,6 @@ public:
 	static jclass krollLoggingClass;
 	static jclass krollDictClass;
 	static jclass tiJsErrorDialogClass;
-	static jclass referenceTableClass;
 
 	// Java methods
 	static jmethodID classGetNameMethod;
@@ -100,34 +119,38 @@ public:
 	static jmethodID longInitMethod;
 	static jmethodID numberDoubleValueMethod;
 	static jmethodID throwableGetMessageMethod;
+	static jmethodID systemIdentityHashCodeMethod;
+	static jmethodID androidLogGetStackTraceStringMethod;
+	static jmethodID weakReferenceInitMethod;
+	static jmethodID weakReferenceGetMethod;
 
 	// Titanium methods and fields
 	static jfieldID v8ObjectPtrField;
 	static jmethodID v8ObjectInitMethod;
 	static jmethodID v8FunctionInitMethod;
+	static jmethodID v8RuntimeScheduleAsyncMethodDrainMethod;
 
 	static jmethodID krollDictInitMethod;
 	static jmethodID krollDictPutMethod;
 
-	static jmethodID referenceTableCreateReferenceMethod;
-	static jmethodID referenceTableDestroyReferenceMethod;
-	static jmethodID referenceTableMakeWeakReferenceMethod;
-	static jmethodID referenceTableClearWeakReferenceMethod;
-	static jmethodID referenceTableGetReferenceMethod;
-
 	static jint krollRuntimeDontIntercept;
+	static jint krollObjectListenerBitmapBits;
 	static jmethodID krollInvocationInitMethod;
 	static jmethodID krollExceptionInitMethod;
 	static jmethodID krollObjectSetHasListenersForEventTypeMethod;
 	static jmethodID krollObjectOnEventFiredMethod;
+	static jmethodID krollObjectGetEventTypeIdMethod;
+	static jmethodID krollObjectGetListenerBitmapMethod;
 	static jmethodID krollProxyCreateProxyMethod;
 	static jmethodID krollProxyCreateDeprecatedProxyMethod;
 	static jfieldID krollProxyKrollObjectField;
 	static jfieldID krollProxyModelListenerField;
+	static jfieldID krollProxyExternalMemorySizeField;
 	static jmethodID krollProxySetIndexedPropertyMethod;
 	static jmethodID krollProxyGetIndexedPropertyMethod;
 	static jmethodID krollProxyOnPropertyChangedMethod;
 	static jmethodID krollProxyOnPropertiesChangedMethod;
+	static jmethodID krollProxyDoFireEventMethod;
 	static jmethodID krollLoggingLogWithDefaultLoggerMethod;
 	static jmethodID krollRuntimeDispatchExceptionMethod;
 
@@ -147,6 +170,12 @@ public:
 	{
 		current = prev;
 	}
+	// The env of the innermost JNI entry point if there is one,
+	// otherwise the cached env of the current thread. The scope is
+	// shared by all threads, so only code which runs on the runtime
+	// thread may use it. Code which can also run on other threads
+	// (destructors, weak callbacks, error reporting) uses
+	// JNIUtil::getJNIEnv().
 	static JNIEnv* getEnv()
 	{
 		return current != NULL ? current : JNIUtil::getJNIEnv();
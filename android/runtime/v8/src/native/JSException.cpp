@@ -7,15 +7,125 @@
 #include <jni.h>
 #include <v8.h>
 
+#include "AndroidUtil.h"
 #include "JNIUtil.h"
 #include "TypeConverter.h"
+#include "V8Util.h"
 
 #include "JSException.h"
 
+#define TAG "JSException"
+
 using namespace v8;
 
 namespace titanium {
 
+// The most Java exceptions kept alive for Errors whose Java stack was not
+// read yet. Past this, the oldest one is released and its Error has no
+// Java stack, so Errors held by the app can't pin an unbounded number of
+// throwables.
+#define MAX_PINNED_EXCEPTIONS 32
+
+// Keeps the Java exception of an Error alive until its Java stack is
+// first read, or until the Error is collected. Pinned exceptions are
+// linked from the oldest to the newest.
+struct JavaStack
+{
+	jthrowable exception;
+	Persistent<String> stack;
+	JavaStack *prev;
+	JavaStack *next;
+};
+
+static Persistent<String> javaClassNameSymbol, javaStackSymbol;
+
+static JavaStack *oldestPinned = NULL;
+static JavaStack *newestPinned = NULL;
+static int pinnedCount = 0;
+
+static void pin(JavaStack *javaStack)
+{
+	javaStack->prev = newestPinned;
+	javaStack->next = NULL;
+	if (newestPinned) {
+		newestPinned->next = javaStack;
+	} else {
+		oldestPinned = javaStack;
+	}
+	newestPinned = javaStack;
+	pinnedCount++;
+}
+
+static void unpin(JNIEnv *env, JavaStack *javaStack)
+{
+	if (!javaStack->exception) {
+		return;
+	}
+
+	if (javaStack->prev) {
+		javaStack->prev->next = javaStack->next;
+	} else {
+		oldestPinned = javaStack->next;
+	}
+	if (javaStack->next) {
+		javaStack->next->prev = javaStack->prev;
+	} else {
+		newestPinned = javaStack->prev;
+	}
+	pinnedCount--;
+
+	if (env) {
+		env->DeleteGlobalRef(javaStack->exception);
+	}
+	javaStack->exception = NULL;
+	javaStack->prev = javaStack->next = NULL;
+}
+
+static void javaStackCollected(Persistent<Value> ref, void *parameter)
+{
+	JavaStack *javaStack = static_cast<JavaStack*>(parameter);
+
+	unpin(JNIScope::getEnv(), javaStack);
+	javaStack->stack.Dispose();
+	delete javaStack;
+
+	ref.Dispose();
+	ref.Clear();
+}
+
+static Handle<Value> getJavaStack(Local<String> property, const AccessorInfo& info)
+{
+	HandleScope scope;
+	JavaStack *javaStack = static_cast<JavaStack*>(External::Unwrap(info.Data()));
+
+	if (javaStack->stack.IsEmpty()) {
+		if (!javaStack->exception) {
+			// released to keep the number of pinned exceptions bounded
+			return Undefined();
+		}
+
+		JNIEnv *env = JNIScope::getEnv();
+		if (!env) {
+			return Undefined();
+		}
+
+		jstring stack = (jstring) env->CallStaticObjectMethod(JNIUtil::androidLogClass,
+			JNIUtil::androidLogGetStackTraceStringMethod, javaStack->exception);
+		if (env->ExceptionCheck()) {
+			env->ExceptionClear();
+			return Undefined();
+		}
+
+		javaStack->stack = Persistent<String>::New(TypeConverter::javaStringToJsString(env, stack)->ToString());
+		env->DeleteLocalRef(stack);
+
+		// The exception is no longer needed once its stack is known.
+		unpin(env, javaStack);
+	}
+
+	return scope.Close(javaStack->stack);
+}
+
 Handle<Value> JSException::fromJavaException(jthrowable javaException)
 {
 	JNIEnv *env = JNIScope::getEnv();
@@ -23,8 +133,6 @@ Handle<Value> JSException::fromJavaException(jthrowable javaException)
 		return GetJNIEnvironmentError();
 	}
 
-	env->ExceptionDescribe();
-
 	bool deleteRef = false;
 	if (!javaException) {
 		javaException = env->ExceptionOccurred();
@@ -32,21 +140,91 @@ Handle<Value> JSException::fromJavaException(jthrowable javaException)
 		deleteRef = true;
 	}
 
-	//env->ExceptionDescribe();
+	if (javaClassNameSymbol.IsEmpty()) {
+		javaClassNameSymbol = SYMBOL_LITERAL("javaClassName");
+		javaStackSymbol = SYMBOL_LITERAL("javaStack");
+	}
 
+	// No other JNI call is allowed while getMessage() has an exception pending.
 	jstring message = (jstring) env->CallObjectMethod(javaException, JNIUtil::throwableGetMessageMethod);
-	if (!message) {
-		return THROW("Java Exception occurred");
+	if (env->ExceptionCheck()) {
+		env->ExceptionClear();
+		message = NULL;
+	}
+
+	jclass exceptionClass = env->GetObjectClass(javaException);
+	jstring className = (jstring) env->CallObjectMethod(exceptionClass, JNIUtil::classGetNameMethod);
+	env->DeleteLocalRef(exceptionClass);
+	if (env->ExceptionCheck()) {
+		env->ExceptionClear();
+	}
+
+	Handle<String> jsMessage = message
+		? TypeConverter::javaStringToJsString(env, message)->ToString()
+		: String::New("Java Exception occurred");
+	Local<Object> error = Exception::Error(jsMessage)->ToObject();
+
+	if (className) {
+		error->Set(javaClassNameSymbol, TypeConverter::javaStringToJsString(env, className),
+			PropertyAttribute(DontEnum));
+		env->DeleteLocalRef(className);
+	}
+	if (message) {
+		env->DeleteLocalRef(message);
+	}
+
+	// The Java stack is only built if the Error is logged or read by the app,
+	// exceptions caught by the app routinely never pay for it.
+	JavaStack *javaStack = new JavaStack();
+	javaStack->exception = (jthrowable) env->NewGlobalRef(javaException);
+	pin(javaStack);
+	if (pinnedCount > MAX_PINNED_EXCEPTIONS) {
+		unpin(env, oldestPinned);
 	}
+	error->SetAccessor(javaStackSymbol, getJavaStack, 0, External::Wrap(javaStack), DEFAULT, DontEnum);
 
-	Handle<Value> jsMessage = TypeConverter::javaStringToJsString(env, message);
-	env->DeleteLocalRef(message);
+	Persistent<Object> weakError = Persistent<Object>::New(error);
+	weakError.MakeWeak(javaStack, javaStackCollected);
 
 	if (deleteRef) {
 		env->DeleteLocalRef(javaException);
 	}
 
-	return ThrowException(Exception::Error(jsMessage->ToString()));
+	return ThrowException(error);
+}
+
+void JSException::dispose(JNIEnv *env)
+{
+	// Errors outliving the runtime lose their Java stack, their
+	// JavaStack is still freed once they are collected.
+	while (oldestPinned) {
+		unpin(env, oldestPinned);
+	}
+
+	if (!javaClassNameSymbol.IsEmpty()) {
+		javaClassNameSymbol.Dispose();
+		javaClassNameSymbol = Persistent<String>();
+		javaStackSymbol.Dispose();
+		javaStackSymbol = Persistent<String>();
+	}
+}
+
+void JSException::logJavaStack(Handle<Value> exception)
+{
+	if (javaStackSymbol.IsEmpty() || !exception->IsObject()) {
+		return;
+	}
+
+	HandleScope scope;
+	Handle<Object> error = exception->ToObject();
+	if (!error->Has(javaStackSymbol)) {
+		return;
+	}
+
+	Handle<Value> stack = error->Get(javaStackSymbol);
+	if (stack->IsString()) {
+		LOGE(TAG, "Uncaught Java exception: %s", *String::Utf8Value(stack));
+	}
 }
 
 }
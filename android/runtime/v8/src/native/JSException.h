@@ -36,7 +36,18 @@ public:
 		return THROW(JNIENV_GET_ERROR_MSG);
 	}
 
+	// Throws a JS Error for the pending (or given) Java exception. The Error
+	// carries the Java class name, and a "javaStack" property built on first read.
+	// Only the newest unread Java exceptions are kept for it, older Errors
+	// lose their "javaStack".
 	static v8::Handle<v8::Value> fromJavaException(jthrowable javaException = NULL);
+
+	// Logs the Java stack of an uncaught Error thrown by fromJavaException().
+	static void logJavaStack(v8::Handle<v8::Value> exception);
+
+	// Releases the pinned Java exceptions and the symbols, called when
+	// the runtime is disposed.
+	static void dispose(JNIEnv *env);
 };
 
 }
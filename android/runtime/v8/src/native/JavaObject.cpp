@@ -9,8 +9,13 @@
 #include "EventEmitter.h"
 #include "JavaObject.h"
 #include "JNIUtil.h"
+#include "ProxyCensus.h"
 #include "ReferenceTable.h"
+#include "V8Runtime.h"
 
+#include <algorithm>
+#include <string.h>
+#include <vector>
 #include <v8.h>
 
 using namespace v8;
@@ -23,19 +28,20 @@ bool JavaObject::useGlobalRefs = true;
 
 static jobject objectMap;
 
-#ifdef TI_DEBUG
-static struct {
-	int total;
-	int detached;
-} stats = {0, 0};
+// Objects re-attached within this many GC epochs keep their strong
+// reference when V8 reports them unreachable again. This avoids
+// flipping a reference on every GC for proxies still in use by Java.
+#define REATTACH_HYSTERESIS_EPOCHS 2
 
-#define UPDATE_STATS(_total, _detached) \
-	stats.total += _total; \
-	stats.detached += _detached; \
-	LOGD(TAG, ">>> JavaObject: total=%i detached=%i <<<", stats.total, stats.detached);
-#else
-#define UPDATE_STATS(total, detached)
-#endif
+// The GC epoch is advanced by every GC prologue. Epoch 0 is never
+// used, a reattachEpoch_ of 0 means the object was never re-attached.
+static uint32_t gcEpoch = 1;
+static JavaObject::GCStats gcStats = { 0, 0, 0, 0 };
+static JavaObject::GCStats lastGCStats = { 0, 0, 0, 0 };
+
+// Objects that V8 found unreachable during the current GC.
+// Their references are made weak together in the GC epilogue.
+static std::vector<JavaObject*> pendingDetaches;
 
 // Callback for V8 letting us know the JavaScript object is no longer reachable.
 // Once we receive this callback we can safely release our strong reference
@@ -43,7 +49,7 @@ static struct {
 static void DetachCallback(v8::Persistent<v8::Value> value, void *data)
 {
 	JavaObject *javaObject = static_cast<JavaObject*>(data);
-	javaObject->detach();
+	javaObject->scheduleDetach();
 }
 
 JavaObject::JavaObject(jobject javaObject)
@@ -51,9 +57,11 @@ JavaObject::JavaObject(jobject javaObject)
 	, javaObject_(NULL)
 	, refTableKey_(0)
 	, isWeakRef_(false)
+	, isDetachPending_(false)
+	, reattachEpoch_(0)
+	, externalMemory_(0)
+	, census_(ProxyCensus::defaultCounters())
 {
-	UPDATE_STATS(1, 1);
-
 	if (javaObject) {
 		attach(javaObject);
 	}
@@ -76,7 +84,7 @@ void JavaObject::newGlobalRef()
 		javaObject_ = globalRef;
 	} else {
 		ASSERT(refTableKey_ == 0);
-		refTableKey_ = ReferenceTable::createReference(javaObject_);
+		refTableKey_ = ReferenceTable::createReference(env, javaObject_);
 		javaObject_ = NULL;
 	}
 }
@@ -99,17 +107,21 @@ jobject JavaObject::getJavaObject()
 
 		return javaObject_;
 	} else {
+		JNIEnv *env = JNIUtil::getJNIEnv();
 		if (isWeakRef_) {
-			UPDATE_STATS(0, -1);
-			jobject javaObject = ReferenceTable::clearWeakReference(refTableKey_);
+			reattachEpoch_ = gcEpoch;
+			gcStats.reattached++;
+			ProxyCensus::increment(census_->reattached);
+			jobject javaObject = ReferenceTable::clearWeakReference(env, refTableKey_);
 			if (javaObject == NULL) {
 				LOGE(TAG, "Java object reference has been invalidated.");
 			}
 			isWeakRef_ = false;
 			handle_.MakeWeak(this, DetachCallback);
+			reportExternalMemory(externalMemory_);
 			return javaObject;
 		}
-		return ReferenceTable::getReference(refTableKey_);
+		return ReferenceTable::getReference(env, refTableKey_);
 	}
 }
 
@@ -128,7 +140,7 @@ void JavaObject::weakGlobalRef()
 		env->DeleteGlobalRef(javaObject_);
 		javaObject_ = weakRef;
 	} else {
-		ReferenceTable::makeWeakReference(refTableKey_);
+		ReferenceTable::makeWeakReference(env, refTableKey_);
 	}
 
 	isWeakRef_ = true;
@@ -151,16 +163,24 @@ void JavaObject::deleteGlobalRef()
 		}
 		javaObject_ = NULL;
 	} else {
-		ReferenceTable::destroyReference(refTableKey_);
+		ReferenceTable::destroyReference(env, refTableKey_);
 		refTableKey_ = 0;
 	}
 }
 
 JavaObject::~JavaObject()
 {
-	UPDATE_STATS(-1, isDetached() ? -1 : 0);
+	if (isDetachPending_) {
+		pendingDetaches.erase(std::remove(pendingDetaches.begin(), pendingDetaches.end(), this),
+			pendingDetaches.end());
+	}
+
+	if (!isDetached()) {
+		reportExternalMemory(-externalMemory_);
+	}
 
 	if (javaObject_ || refTableKey_ > 0) {
+		ProxyCensus::decrement(census_->live);
 		deleteGlobalRef();
 	}
 }
@@ -180,7 +200,15 @@ void JavaObject::wrap(Handle<Object> jsObject)
 void JavaObject::attach(jobject javaObject)
 {
 	ASSERT((javaObject && javaObject_ == NULL) || javaObject == NULL);
-	UPDATE_STATS(0, -1);
+
+	if (javaObject) {
+		ProxyCensus::increment(census_->created);
+		ProxyCensus::increment(census_->live);
+	} else {
+		reattachEpoch_ = gcEpoch;
+		gcStats.reattached++;
+		ProxyCensus::increment(census_->reattached);
+	}
 
 	handle_.MakeWeak(this, DetachCallback);
 	handle_.MarkIndependent();
@@ -189,6 +217,9 @@ void JavaObject::attach(jobject javaObject)
 		javaObject_ = javaObject;
 	}
 	newGlobalRef();
+
+	// A re-attached object holds its external memory again.
+	reportExternalMemory(externalMemory_);
 }
 
 void JavaObject::detach()
@@ -199,9 +230,13 @@ void JavaObject::detach()
 		return;
 	}
 
-	UPDATE_STATS(0, 1);
+	ProxyCensus::increment(census_->detached);
 
 	weakGlobalRef();
+
+	// Detaching usually happens in the GC epilogue. Only a negative
+	// adjustment is made here, which never triggers another GC.
+	reportExternalMemory(-externalMemory_);
 }
 
 bool JavaObject::isDetached()
@@ -209,5 +244,112 @@ bool JavaObject::isDetached()
 	return (javaObject_ == NULL && refTableKey_ == 0) || isWeakRef_;
 }
 
+void JavaObject::adjustExternalMemory(int64_t delta)
+{
+	int64_t size = externalMemory_ + delta;
+	if (size < 0) {
+		LOGE(TAG, "External memory released more than reported (%lld bytes).", (long long) -size);
+		size = 0;
+	}
+
+	delta = size - externalMemory_;
+	externalMemory_ = size;
+
+	if (!isDetached()) {
+		reportExternalMemory(delta);
+	}
+}
+
+void JavaObject::reportExternalMemory(int64_t delta)
+{
+	if (delta != 0) {
+		V8::AdjustAmountOfExternalAllocatedMemory((intptr_t) delta);
+	}
+}
+
+void JavaObject::scheduleDetach()
+{
+	// Keep the JavaScript object alive, it is only released
+	// once the Java object has been finalized.
+	handle_.MakeWeak(this, DetachCallback);
+
+	if (isDetachPending_ || isDetached()) {
+		return;
+	}
+
+	if (reattachEpoch_ != 0 && gcEpoch - reattachEpoch_ < REATTACH_HYSTERESIS_EPOCHS) {
+		gcStats.deferred++;
+		return;
+	}
+
+	isDetachPending_ = true;
+	pendingDetaches.push_back(this);
+}
+
+void JavaObject::onGCPrologue(GCType type, GCCallbackFlags flags)
+{
+	gcEpoch++;
+}
+
+// Weak callbacks run between the prologue and epilogue of a GC,
+// so every object reported unreachable by this GC is detached here.
+void JavaObject::onGCEpilogue(GCType type, GCCallbackFlags flags)
+{
+	for (std::vector<JavaObject*>::iterator i = pendingDetaches.begin(); i != pendingDetaches.end(); ++i) {
+		JavaObject *javaObject = *i;
+		javaObject->isDetachPending_ = false;
+		javaObject->detach();
+	}
+
+	gcStats.epoch = gcEpoch;
+	gcStats.detached = pendingDetaches.size();
+	pendingDetaches.clear();
+
+	if (V8Runtime::DBG && (gcStats.detached > 0 || gcStats.reattached > 0)) {
+		LOGD(TAG, "GC epoch %u: detached=%u reattached=%u deferred=%u",
+			gcStats.epoch, gcStats.detached, gcStats.reattached, gcStats.deferred);
+	}
+
+	lastGCStats = gcStats;
+	memset(&gcStats, 0, sizeof(gcStats));
+}
+
+void JavaObject::initGCCallbacks()
+{
+	V8::AddGCPrologueCallback(onGCPrologue);
+	V8::AddGCEpilogueCallback(onGCEpilogue);
+}
+
+void JavaObject::disposeGCCallbacks()
+{
+	V8::RemoveGCPrologueCallback(onGCPrologue);
+	V8::RemoveGCEpilogueCallback(onGCEpilogue);
+
+	for (std::vector<JavaObject*>::iterator i = pendingDetaches.begin(); i != pendingDetaches.end(); ++i) {
+		(*i)->isDetachPending_ = false;
+	}
+	pendingDetaches.clear();
+}
+
+void JavaObject::getGCStats(GCStats *stats)
+{
+	*stats = lastGCStats;
+}
+
+Handle<Value> JavaObject::getGCStats(const Arguments& args)
+{
+	HandleScope scope;
+	GCStats current;
+	getGCStats(&current);
+
+	Local<Object> result = Object::New();
+	result->Set(String::NewSymbol("epoch"), Integer::NewFromUnsigned(current.epoch));
+	result->Set(String::NewSymbol("detached"), Integer::NewFromUnsigned(current.detached));
+	result->Set(String::NewSymbol("reattached"), Integer::NewFromUnsigned(current.reattached));
+	result->Set(String::NewSymbol("deferred"), Integer::NewFromUnsigned(current.deferred));
+
+	return scope.Close(result);
+}
+
 }
 
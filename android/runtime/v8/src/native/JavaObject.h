@@ -9,9 +9,11 @@
 
 #include <assert.h>
 #include <jni.h>
+#include <stdint.h>
 
 #include "EventEmitter.h"
 #include "NativeObject.h"
+#include "ProxyCensus.h"
 
 namespace titanium {
 
@@ -58,24 +60,77 @@ public:
 	// Check if this instance is detached from a Java object.
 	bool isDetached();
 
+	// Counters of the proxy class of this object. Must be
+	// set before the first Java object is attached.
+	ProxyCensus::Counters* census()
+	{
+		return census_;
+	}
+
+	void setCensus(ProxyCensus::Counters *census)
+	{
+		census_ = census;
+	}
+
+	// Queue this object to be detached at the end of the current GC.
+	// Called from the V8 weak callback of the JavaScript object.
+	void scheduleDetach();
+
 	// When useGlobalRefs is false, you MUST DeleteLocalRef()
 	// the returned jobject when you are done using it.
 	// This is guaranteed to return a valid reference.
 	jobject getJavaObject();
 
+	// Adjust the number of bytes held by the Java object outside of
+	// the Java and JavaScript heaps (ex: bitmaps, direct buffers).
+	// The bytes are reported to V8 as external memory while the
+	// Java object is attached, so V8 can account for them when
+	// scheduling a GC. They are released once detached.
+	void adjustExternalMemory(int64_t delta);
+
 	// True when we use global refs for the wrapped jobject.
 	// This is false for the emulator since it has a low limit
 	// of how many global refs you can hold. Instead we use an internal
 	// hash map for holding onto references to avoid this limit.
 	static bool useGlobalRefs;
+
+	// Number of references flipped between strong and weak
+	// during one GC epoch (from one GC epilogue to the next).
+	struct GCStats
+	{
+		uint32_t epoch;
+		uint32_t detached;   // demoted to weak in a batch at the end of the GC
+		uint32_t reattached; // promoted back to strong during the epoch
+		uint32_t deferred;   // demotions postponed for recently re-attached objects
+	};
+
+	// Install the V8 GC prologue/epilogue callbacks that drive
+	// the batched detach policy.
+	static void initGCCallbacks();
+	static void disposeGCCallbacks();
+
+	// Counters of the last completed GC epoch.
+	static void getGCStats(GCStats *stats);
+
+	// Ti.API.getGCStats(), the counters of the last GC epoch as an object.
+	static v8::Handle<v8::Value> getGCStats(const v8::Arguments& args);
+
 private:
 	jobject javaObject_;
 	jint refTableKey_;
 	bool isWeakRef_;
+	bool isDetachPending_;
+	uint32_t reattachEpoch_;
+	int64_t externalMemory_;
+	ProxyCensus::Counters *census_;
+
+	static void onGCPrologue(v8::GCType type, v8::GCCallbackFlags flags);
+	static void onGCEpilogue(v8::GCType type, v8::GCCallbackFlags flags);
 
 	void newGlobalRef();
 	void weakGlobalRef();
 	void deleteGlobalRef();
+	void reportExternalMemory(int64_t delta);
 };
 
 } // namespace titanium
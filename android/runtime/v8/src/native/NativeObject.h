@@ -13,6 +13,8 @@
 #include <v8.h>
 #include <assert.h>
 
+#include "WrapperPool.h"
+
 namespace titanium {
 
 class ProxyFactory;
@@ -41,6 +43,18 @@ public:
 		}
 	}
 
+	// Wrappers are allocated from the size-class pools of WrapperPool.
+	// The virtual destructor makes delete pass the size of the actual type.
+	static void* operator new(size_t size)
+	{
+		return WrapperPool::allocate(size);
+	}
+
+	static void operator delete(void *ptr, size_t size)
+	{
+		WrapperPool::release(ptr, size);
+	}
+
 	inline v8::Local<v8::Object> getHandle()
 	{
 		return v8::Local<v8::Object>::New(handle_);
@@ -0,0 +1,357 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#include <errno.h>
+#include <map>
+#include <stdio.h>
+#include <string>
+#include <string.h>
+#include <time.h>
+#include <v8.h>
+#include <v8-profiler.h>
+
+#include "AndroidUtil.h"
+#include "CpuProfileWriter.h"
+#include "JSException.h"
+#include "Profiler.h"
+
+#define TAG "Profiler"
+
+// Built against the profiler API of the bundled V8 (3.9.24, see
+// ndk-modules/libv8): HeapProfiler::TakeSnapshot, HeapSnapshot::Serialize,
+// GetNodesCount and GetNode, HeapGraphNode::GetId, CpuProfiler::StartProfiling
+// and StopProfiling, and the CpuProfileNode accessors. Later additions such
+// as SnapshotObjectId, StartHeapObjectsTracking, GetMaxSnapshotJSObjectId and
+// the --cpu_profiler_sampling_interval flag are not available there.
+
+// Prefix of the native paths returned by Ti.Filesystem.File.nativePath
+#define FILE_URL_PREFIX "file://"
+
+using namespace v8;
+
+namespace titanium {
+
+bool Profiler::enabled = false;
+
+// HeapGraphNode::GetId() returns a 64 bit id in V8 3.9.
+typedef uint64_t ObjectId;
+
+static bool trackingAllocations = false;
+static ObjectId trackingStartId = 0;
+
+// Start time in seconds of each running CPU profile, by label.
+static std::map<std::string, double> cpuProfiles;
+
+// Writes the chunks serialized by V8 to a file.
+class FileOutputStream : public OutputStream
+{
+public:
+	FileOutputStream(FILE *file)
+		: file_(file)
+		, failed_(false)
+	{
+	}
+
+	virtual void EndOfStream()
+	{
+	}
+
+	virtual int GetChunkSize()
+	{
+		return 64 * 1024;
+	}
+
+	virtual WriteResult WriteAsciiChunk(char *data, int size)
+	{
+		if (fwrite(data, 1, size, file_) != (size_t) size) {
+			failed_ = true;
+			return kAbort;
+		}
+		return kContinue;
+	}
+
+	bool failed()
+	{
+		return failed_;
+	}
+
+private:
+	FILE *file_;
+	bool failed_;
+};
+
+static const char *toNativePath(const char *path)
+{
+	size_t prefixLength = strlen(FILE_URL_PREFIX);
+	if (strncmp(path, FILE_URL_PREFIX, prefixLength) == 0) {
+		return path + prefixLength;
+	}
+	return path;
+}
+
+// Ids are assigned in allocation order and kept across snapshots,
+// the highest one belongs to the most recently allocated object.
+static ObjectId getMaxObjectId(const HeapSnapshot *snapshot)
+{
+	ObjectId maxId = 0;
+	int count = snapshot->GetNodesCount();
+	for (int i = 0; i < count; ++i) {
+		ObjectId id = snapshot->GetNode(i)->GetId();
+		if (id > maxId) {
+			maxId = id;
+		}
+	}
+	return maxId;
+}
+
+static bool checkEnabled()
+{
+	if (!Profiler::enabled) {
+		LOGW(TAG, "Profiling is not enabled, set ti.android.profiling in tiapp.xml");
+	}
+	return Profiler::enabled;
+}
+
+// Writes a heap snapshot to path and returns the highest object id in maxId.
+static bool writeHeapSnapshot(const char *path, ObjectId *maxId)
+{
+	HandleScope scope;
+
+	path = toNativePath(path);
+	FILE *file = fopen(path, "w");
+	if (!file) {
+		LOGE(TAG, "Unable to open %s for the heap snapshot: %s", path, strerror(errno));
+		return false;
+	}
+
+	const HeapSnapshot *snapshot = HeapProfiler::TakeSnapshot(String::New(path));
+
+	FileOutputStream stream(file);
+	snapshot->Serialize(&stream, HeapSnapshot::kJSON);
+	fclose(file);
+
+	*maxId = getMaxObjectId(snapshot);
+	LOGI(TAG, "Heap snapshot written to %s (%d nodes, max id %llu)",
+		path, snapshot->GetNodesCount(), (unsigned long long) *maxId);
+
+	// The snapshot is only needed for the export.
+	const_cast<HeapSnapshot*>(snapshot)->Delete();
+
+	return !stream.failed();
+}
+
+bool Profiler::takeHeapSnapshot(const char *path)
+{
+	if (!checkEnabled()) {
+		return false;
+	}
+
+	ObjectId maxId;
+	return writeHeapSnapshot(path, &maxId);
+}
+
+bool Profiler::startAllocationTracking(const char *path)
+{
+	if (!checkEnabled()) {
+		return false;
+	}
+
+	if (trackingAllocations) {
+		LOGW(TAG, "Allocation tracking is already started, last object id %llu",
+			(unsigned long long) trackingStartId);
+		return true;
+	}
+
+	// Every object allocated from now on gets an id above the last one.
+	if (!writeHeapSnapshot(path, &trackingStartId)) {
+		return false;
+	}
+	trackingAllocations = true;
+
+	LOGI(TAG, "Allocation tracking started, last object id %llu", (unsigned long long) trackingStartId);
+	return true;
+}
+
+bool Profiler::stopAllocationTracking(const char *path)
+{
+	if (!trackingAllocations) {
+		LOGW(TAG, "Allocation tracking is not started");
+		return false;
+	}
+
+	bool written = takeHeapSnapshot(path);
+	trackingAllocations = false;
+
+	LOGI(TAG, "Allocation tracking stopped, objects allocated since the start have an id above %llu",
+		(unsigned long long) trackingStartId);
+
+	return written;
+}
+
+bool Profiler::isTrackingAllocations()
+{
+	return trackingAllocations;
+}
+
+uint64_t Profiler::getTrackingStartId()
+{
+	return trackingStartId;
+}
+
+static double currentTime()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static void writeCpuProfileNode(CpuProfileWriter &writer, const CpuProfileNode *node)
+{
+	String::Utf8Value functionName(node->GetFunctionName());
+	String::Utf8Value url(node->GetScriptResourceName());
+
+	writer.beginNode(*functionName, *url, node->GetLineNumber(),
+		(unsigned int) node->GetSelfSamplesCount(), node->GetCallUid());
+
+	int childrenCount = node->GetChildrenCount();
+	for (int i = 0; i < childrenCount; ++i) {
+		writeCpuProfileNode(writer, node->GetChild(i));
+	}
+
+	writer.endNode();
+}
+
+bool Profiler::startCpuProfiling(const char *label)
+{
+	if (!checkEnabled()) {
+		return false;
+	}
+
+	if (cpuProfiles.find(label) != cpuProfiles.end()) {
+		LOGW(TAG, "CPU profile \"%s\" is already started", label);
+		return false;
+	}
+
+	HandleScope scope;
+	CpuProfiler::StartProfiling(String::New(label));
+	cpuProfiles[label] = currentTime();
+
+	return true;
+}
+
+bool Profiler::stopCpuProfiling(const char *label, const char *path)
+{
+	std::map<std::string, double>::iterator i = cpuProfiles.find(label);
+	if (i == cpuProfiles.end()) {
+		LOGW(TAG, "CPU profile \"%s\" is not started", label);
+		return false;
+	}
+
+	double startTime = i->second;
+	cpuProfiles.erase(i);
+
+	HandleScope scope;
+	const CpuProfile *profile = CpuProfiler::StopProfiling(String::New(label));
+	double endTime = currentTime();
+	if (!profile) {
+		LOGE(TAG, "CPU profile \"%s\" could not be stopped", label);
+		return false;
+	}
+
+	path = toNativePath(path);
+	FILE *file = fopen(path, "w");
+	if (!file) {
+		LOGE(TAG, "Unable to open %s for the CPU profile: %s", path, strerror(errno));
+		const_cast<CpuProfile*>(profile)->Delete();
+		return false;
+	}
+
+	CpuProfileWriter writer(file);
+	writer.begin(startTime, endTime);
+	writeCpuProfileNode(writer, profile->GetTopDownRoot());
+	bool written = writer.end();
+	fclose(file);
+
+	const_cast<CpuProfile*>(profile)->Delete();
+
+	LOGI(TAG, "CPU profile \"%s\" written to %s (%.3fs)", label, path, endTime - startTime);
+
+	return written;
+}
+
+Handle<Value> Profiler::takeHeapSnapshot(const Arguments& args)
+{
+	HandleScope scope;
+	if (args.Length() < 1) {
+		return JSException::Error("takeHeapSnapshot: missing required path argument");
+	}
+
+	String::Utf8Value path(args[0]);
+	return scope.Close(Boolean::New(takeHeapSnapshot(*path)));
+}
+
+Handle<Value> Profiler::startAllocationTracking(const Arguments& args)
+{
+	HandleScope scope;
+	if (args.Length() < 1) {
+		return JSException::Error("startAllocationTracking: missing required path argument");
+	}
+
+	String::Utf8Value path(args[0]);
+	if (!startAllocationTracking(*path)) {
+		return scope.Close(Number::New(-1));
+	}
+	return scope.Close(Number::New((double) trackingStartId));
+}
+
+Handle<Value> Profiler::stopAllocationTracking(const Arguments& args)
+{
+	HandleScope scope;
+	if (args.Length() < 1) {
+		return JSException::Error("stopAllocationTracking: missing required path argument");
+	}
+
+	String::Utf8Value path(args[0]);
+	return scope.Close(Boolean::New(stopAllocationTracking(*path)));
+}
+
+Handle<Value> Profiler::startProfiling(const Arguments& args)
+{
+	HandleScope scope;
+	if (args.Length() < 1) {
+		return JSException::Error("startProfiling: missing required label argument");
+	}
+
+	String::Utf8Value label(args[0]);
+	return scope.Close(Boolean::New(startCpuProfiling(*label)));
+}
+
+Handle<Value> Profiler::stopProfiling(const Arguments& args)
+{
+	HandleScope scope;
+	if (args.Length() < 2) {
+		return JSException::Error("stopProfiling: missing required label and path arguments");
+	}
+
+	String::Utf8Value label(args[0]);
+	String::Utf8Value path(args[1]);
+	return scope.Close(Boolean::New(stopCpuProfiling(*label, *path)));
+}
+
+void Profiler::dispose()
+{
+	for (std::map<std::string, double>::iterator i = cpuProfiles.begin(); i != cpuProfiles.end(); ++i) {
+		HandleScope scope;
+		CpuProfiler::StopProfiling(String::New(i->first.c_str()));
+	}
+	cpuProfiles.clear();
+	CpuProfiler::DeleteAllProfiles();
+
+	trackingAllocations = false;
+	HeapProfiler::DeleteAllSnapshots();
+}
+
+} // namespace titanium
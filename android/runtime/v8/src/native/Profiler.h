@@ -0,0 +1,56 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#ifndef TI_KROLL_PROFILER_H
+#define TI_KROLL_PROFILER_H
+
+#include <stdint.h>
+#include <v8.h>
+
+namespace titanium {
+
+// Native profiling surface of the runtime. Heap snapshots and CPU
+// profiles are written in the JSON formats of Chrome DevTools
+// (.heapsnapshot and .cpuprofile).
+// Only available when profiling is enabled, which is the case for
+// development builds or when "ti.android.profiling" is set in tiapp.xml.
+class Profiler
+{
+public:
+	static bool enabled;
+
+	// Write a heap snapshot of the JavaScript heap to path.
+	static bool takeHeapSnapshot(const char *path);
+
+	// Track the objects allocated from now on. Starting writes a first
+	// heap snapshot to path and records its highest object id, stopping
+	// writes a second one in which the objects allocated in between are
+	// the ones with an id above it.
+	static bool startAllocationTracking(const char *path);
+	static bool stopAllocationTracking(const char *path);
+	static bool isTrackingAllocations();
+	static uint64_t getTrackingStartId();
+
+	// Start sampling the JavaScript call stacks in a CPU profile named
+	// label. The bundled V8 samples at a fixed interval of 1 ms.
+	static bool startCpuProfiling(const char *label);
+
+	// Stop the CPU profile named label and write it to path.
+	static bool stopCpuProfiling(const char *label, const char *path);
+
+	// JavaScript bindings exposed on Ti.API.
+	static v8::Handle<v8::Value> takeHeapSnapshot(const v8::Arguments& args);
+	static v8::Handle<v8::Value> startAllocationTracking(const v8::Arguments& args);
+	static v8::Handle<v8::Value> stopAllocationTracking(const v8::Arguments& args);
+	static v8::Handle<v8::Value> startProfiling(const v8::Arguments& args);
+	static v8::Handle<v8::Value> stopProfiling(const v8::Arguments& args);
+
+	static void dispose();
+};
+
+} // namespace titanium
+
+#endif
@@ -6,6 +6,8 @@
  */
 #include <jni.h>
 #include <string.h>
+#include <map>
+#include <string>
 #include <v8.h>
 
 #include "AndroidUtil.h"
@@ -14,6 +16,7 @@
 #include "JNIUtil.h"
 #include "JSException.h"
 #include "Proxy.h"
+#include "ProxyCensus.h"
 #include "ProxyFactory.h"
 #include "TypeConverter.h"
 #include "V8Util.h"
@@ -30,20 +33,34 @@ namespace titanium {
 Persistent<FunctionTemplate> Proxy::baseProxyTemplate;
 Persistent<String> Proxy::javaClassSymbol;
 Persistent<String> Proxy::constructorSymbol;
+Persistent<String> Proxy::censusSymbol;
 Persistent<String> Proxy::inheritSymbol;
 Persistent<String> Proxy::propertiesSymbol;
 Persistent<String> Proxy::lengthSymbol;
 Persistent<String> Proxy::sourceUrlSymbol;
 
 Proxy::Proxy(jobject javaProxy) :
-	JavaObject(javaProxy)
+	JavaObject(javaProxy),
+	listenerBitmap_(NULL),
+	listenerBits_(NULL)
 {
 }
 
+Proxy::~Proxy()
+{
+	if (listenerBitmap_) {
+		JNIEnv *env = JNIUtil::getJNIEnv();
+		if (env) {
+			env->DeleteGlobalRef(listenerBitmap_);
+		}
+	}
+}
+
 void Proxy::bindProxy(Handle<Object> exports)
 {
 	javaClassSymbol = SYMBOL_LITERAL("__javaClass__");
 	constructorSymbol = SYMBOL_LITERAL("constructor");
+	censusSymbol = SYMBOL_LITERAL("__census__");
 	inheritSymbol = SYMBOL_LITERAL("inherit");
 	propertiesSymbol = SYMBOL_LITERAL("_properties");
 	lengthSymbol = SYMBOL_LITERAL("length");
@@ -123,6 +140,38 @@ void Proxy::setProperty(Local<String> property, Local<Value> value, const Access
 	setPropertyOnProxy(property, value, info.This());
 }
 
+bool Proxy::getCachedProperty(Local<String> property, Local<Object> proxy, Handle<Value>& value)
+{
+	Local<Value> properties = proxy->Get(propertiesSymbol);
+	if (!properties->IsObject()) {
+		return false;
+	}
+
+	Local<Object> propertyMap = properties->ToObject();
+	if (!propertyMap->Has(property)) {
+		return false;
+	}
+
+	value = propertyMap->Get(property);
+	return true;
+}
+
+void Proxy::setCachedProperty(Local<String> property, Handle<Value> value, Local<Object> proxy)
+{
+	Local<Value> properties = proxy->Get(propertiesSymbol);
+	if (properties->IsObject()) {
+		properties->ToObject()->Set(property, value);
+	}
+}
+
+void Proxy::clearCachedProperty(Local<String> property, Local<Object> proxy)
+{
+	Local<Value> properties = proxy->Get(propertiesSymbol);
+	if (properties->IsObject()) {
+		properties->ToObject()->Delete(property);
+	}
+}
+
 static void onPropertyChangedForProxy(Local<String> property, Local<Value> value, Local<Object> proxyObject)
 {
 	Proxy* proxy = NativeObject::Unwrap<Proxy>(proxyObject);
@@ -176,6 +225,12 @@ Handle<Value> Proxy::onPropertyChanged(const Arguments& args)
 
 Handle<Value> Proxy::getIndexedProperty(uint32_t index, const AccessorInfo& info)
 {
+	// Objects backed by external array data (i.e. Ti.Buffer) are read
+	// directly by V8, returning an empty handle skips the interceptor.
+	if (info.Holder()->HasIndexedPropertiesInExternalArrayData()) {
+		return Handle<Value>();
+	}
+
 	JNIEnv* env = JNIScope::getEnv();
 	if (!env) {
 		return JSException::GetJNIEnvironmentError();
@@ -199,6 +254,10 @@ Handle<Value> Proxy::getIndexedProperty(uint32_t index, const AccessorInfo& info
 
 Handle<Value> Proxy::setIndexedProperty(uint32_t index, Local<Value> value, const AccessorInfo& info)
 {
+	if (info.Holder()->HasIndexedPropertiesInExternalArrayData()) {
+		return Handle<Value>();
+	}
+
 	JNIEnv* env = JNIScope::getEnv();
 	if (!env) {
 		LOG_JNIENV_GET_ERROR(TAG);
@@ -225,6 +284,65 @@ Handle<Value> Proxy::setIndexedProperty(uint32_t index, Local<Value> value, cons
 	return value;
 }
 
+// Ids of the event types, assigned by KrollObject.getEventTypeId().
+// Only used on the KrollRuntime thread.
+static std::map<std::string, int> eventTypeIds;
+
+static int getEventTypeId(JNIEnv *env, Local<String> eventType)
+{
+	String::Utf8Value name(eventType);
+	std::map<std::string, int>::iterator i = eventTypeIds.find(*name);
+	if (i != eventTypeIds.end()) {
+		return i->second;
+	}
+
+	jstring javaEventType = TypeConverter::jsStringToJavaString(env, eventType);
+	jint id = env->CallStaticIntMethod(JNIUtil::krollObjectClass,
+		JNIUtil::krollObjectGetEventTypeIdMethod, javaEventType);
+	env->DeleteLocalRef(javaEventType);
+
+	if (env->ExceptionCheck()) {
+		env->ExceptionDescribe();
+		env->ExceptionClear();
+		return -1;
+	}
+
+	eventTypeIds[*name] = id;
+	return id;
+}
+
+uint8_t* Proxy::getListenerBits(JNIEnv *env)
+{
+	if (listenerBits_) {
+		return listenerBits_;
+	}
+
+	jobject javaProxy = getJavaObject();
+	jobject krollObject = env->GetObjectField(javaProxy, JNIUtil::krollProxyKrollObjectField);
+	if (!JavaObject::useGlobalRefs) {
+		env->DeleteLocalRef(javaProxy);
+	}
+	if (!krollObject) {
+		return NULL;
+	}
+
+	jobject bitmap = env->CallObjectMethod(krollObject, JNIUtil::krollObjectGetListenerBitmapMethod);
+	env->DeleteLocalRef(krollObject);
+	if (!bitmap) {
+		if (env->ExceptionCheck()) {
+			env->ExceptionDescribe();
+			env->ExceptionClear();
+		}
+		return NULL;
+	}
+
+	listenerBitmap_ = env->NewGlobalRef(bitmap);
+	env->DeleteLocalRef(bitmap);
+	listenerBits_ = static_cast<uint8_t*>(env->GetDirectBufferAddress(listenerBitmap_));
+
+	return listenerBits_;
+}
+
 Handle<Value> Proxy::hasListenersForEventType(const Arguments& args)
 {
 	JNIEnv* env = JNIScope::getEnv();
@@ -237,6 +355,27 @@ Handle<Value> Proxy::hasListenersForEventType(const Arguments& args)
 	Local<String> eventType = args[0]->ToString();
 	Local<Boolean> hasListeners = args[1]->ToBoolean();
 
+	// Listeners for most event types are tracked in a bitmap shared with
+	// the KrollObject. Java is only called when a bit actually changes,
+	// so the proxy can be notified of the change.
+	int id = getEventTypeId(env, eventType);
+	if (id >= 0 && id < JNIUtil::krollObjectListenerBitmapBits) {
+		uint8_t *bits = proxy->getListenerBits(env);
+		if (bits) {
+			uint8_t mask = 1 << (id & 7);
+			bool listening = (bits[id >> 3] & mask) != 0;
+			if (listening == hasListeners->Value()) {
+				return Undefined();
+			}
+
+			if (hasListeners->Value()) {
+				bits[id >> 3] |= mask;
+			} else {
+				bits[id >> 3] &= ~mask;
+			}
+		}
+	}
+
 	jobject javaProxy = proxy->getJavaObject();
 	jobject krollObject = env->GetObjectField(javaProxy, JNIUtil::krollProxyKrollObjectField);
 	jstring javaEventType = TypeConverter::jsStringToJavaString(env, eventType);
@@ -302,6 +441,9 @@ Handle<FunctionTemplate> Proxy::inheritProxyTemplate(
 
 	inheritedTemplate->Set(javaClassSymbol, wrappedClass, PropertyAttribute(DontDelete | DontEnum));
 
+	ProxyCensus::Counters *census = ProxyCensus::forClass(*String::Utf8Value(className));
+	inheritedTemplate->Set(censusSymbol, External::Wrap(census), PropertyAttribute(DontDelete | DontEnum));
+
 	inheritedTemplate->InstanceTemplate()->SetInternalFieldCount(kInternalFieldCount);
 	inheritedTemplate->SetClassName(className);
 	inheritedTemplate->Inherit(superTemplate);
@@ -329,12 +471,17 @@ Handle<Value> Proxy::proxyConstructor(const Arguments& args)
 	Proxy* proxy = new Proxy(NULL);
 	proxy->wrap(jsProxy);
 
+	Handle<Value> census = constructor->Get(censusSymbol);
+	if (!census->IsUndefined()) {
+		proxy->setCensus(static_cast<ProxyCensus::Counters*>(External::Unwrap(census)));
+	}
+
 	// If ProxyFactory::createV8Proxy invoked us, unwrap
 	// the pre-created Java proxy it sent.
 	jobject javaProxy = ProxyFactory::unwrapJavaProxy(args);
 	bool deleteRef = false;
 	if (!javaProxy) {
-		javaProxy = ProxyFactory::createJavaProxy(javaClass, jsProxy, args);
+		javaProxy = ProxyFactory::createJavaProxy(javaClass, constructor, jsProxy, args);
 		deleteRef = true;
 	}
 	proxy->attach(javaProxy);
@@ -480,6 +627,9 @@ void Proxy::dispose()
 	constructorSymbol.Dispose();
 	constructorSymbol = Persistent<String>();
 
+	censusSymbol.Dispose();
+	censusSymbol = Persistent<String>();
+
 	inheritSymbol.Dispose();
 	inheritSymbol = Persistent<String>();
 
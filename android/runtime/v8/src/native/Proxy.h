@@ -26,11 +26,12 @@ public:
 	};
 
 	static v8::Persistent<v8::FunctionTemplate> baseProxyTemplate;
-	static v8::Persistent<v8::String> javaClassSymbol, constructorSymbol;
+	static v8::Persistent<v8::String> javaClassSymbol, constructorSymbol, censusSymbol;
 	static v8::Persistent<v8::String> inheritSymbol, propertiesSymbol;
 	static v8::Persistent<v8::String> lengthSymbol, sourceUrlSymbol;
 
 	Proxy(jobject javaProxy);
+	virtual ~Proxy();
 
 	// Initialize the base proxy template
 	static void bindProxy(v8::Handle<v8::Object> exports);
@@ -48,6 +49,18 @@ public:
 							v8::Local<v8::Value> value,
 							const v8::AccessorInfo& info);
 
+	// Access to values cached in the internal property map for getters
+	// declared with @Kroll.getProperty(cache=true). The Java proxy keeps
+	// these values current through V8Object.nativeSetProperty().
+	static bool getCachedProperty(v8::Local<v8::String> property,
+	                              v8::Local<v8::Object> proxy,
+	                              v8::Handle<v8::Value>& value);
+	static void setCachedProperty(v8::Local<v8::String> property,
+	                              v8::Handle<v8::Value> value,
+	                              v8::Local<v8::Object> proxy);
+	static void clearCachedProperty(v8::Local<v8::String> property,
+	                                v8::Local<v8::Object> proxy);
+
 	// Setter that reports to the Java proxy when a property has changed.
 	// Used by proxies that use accessor based properties.
 	static void onPropertyChanged(v8::Local<v8::String> property,
@@ -117,6 +130,13 @@ public:
 private:
 	static v8::Handle<v8::Value> proxyConstructor(const v8::Arguments& args);
 	static v8::Handle<v8::Value> proxyOnPropertiesChanged(const v8::Arguments& args);
+
+	// Returns the bits of KrollObject.getListenerBitmap(), which Java reads
+	// to check for listeners. NULL if the bitmap could not be obtained.
+	uint8_t* getListenerBits(JNIEnv *env);
+
+	jobject listenerBitmap_;
+	uint8_t *listenerBits_;
 };
 
 }
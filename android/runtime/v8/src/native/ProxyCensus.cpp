@@ -0,0 +1,105 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#include <pthread.h>
+#include <vector>
+#include <v8.h>
+
+#include "AndroidUtil.h"
+#include "ProxyCensus.h"
+
+#define TAG "ProxyCensus"
+
+using namespace v8;
+
+namespace titanium {
+
+// Classes are only registered when their template is created,
+// the lock is never taken when a counter is updated.
+static pthread_mutex_t registryMutex = PTHREAD_MUTEX_INITIALIZER;
+static std::vector<ProxyCensus::Counters*> registry;
+static ProxyCensus::Counters* javaObjectCounters = NULL;
+static pthread_once_t javaObjectCountersOnce = PTHREAD_ONCE_INIT;
+
+static void createJavaObjectCounters()
+{
+	javaObjectCounters = ProxyCensus::forClass("JavaObject");
+}
+
+ProxyCensus::Counters* ProxyCensus::forClass(const char *className)
+{
+	pthread_mutex_lock(&registryMutex);
+
+	Counters *counters = NULL;
+	for (std::vector<Counters*>::iterator i = registry.begin(); i != registry.end(); ++i) {
+		if ((*i)->className == className) {
+			counters = *i;
+			break;
+		}
+	}
+
+	if (!counters) {
+		counters = new Counters();
+		counters->className = className;
+		counters->created = counters->live = counters->detached = 0;
+		counters->reattached = counters->released = 0;
+		registry.push_back(counters);
+	}
+
+	pthread_mutex_unlock(&registryMutex);
+	return counters;
+}
+
+ProxyCensus::Counters* ProxyCensus::defaultCounters()
+{
+	// Wrappers can be created on any thread, the counters are created once.
+	pthread_once(&javaObjectCountersOnce, createJavaObjectCounters);
+	return javaObjectCounters;
+}
+
+Handle<Object> ProxyCensus::toObject()
+{
+	HandleScope scope;
+	Local<Object> census = Object::New();
+
+	pthread_mutex_lock(&registryMutex);
+	for (std::vector<Counters*>::iterator i = registry.begin(); i != registry.end(); ++i) {
+		Counters *counters = *i;
+		Local<Object> entry = Object::New();
+		entry->Set(String::NewSymbol("created"), Integer::New(counters->created));
+		entry->Set(String::NewSymbol("live"), Integer::New(counters->live));
+		entry->Set(String::NewSymbol("detached"), Integer::New(counters->detached));
+		entry->Set(String::NewSymbol("reattached"), Integer::New(counters->reattached));
+		entry->Set(String::NewSymbol("released"), Integer::New(counters->released));
+		census->Set(String::New(counters->className.c_str()), entry);
+	}
+	pthread_mutex_unlock(&registryMutex);
+
+	return scope.Close(census);
+}
+
+Handle<Value> ProxyCensus::getProxyCensus(const Arguments& args)
+{
+	HandleScope scope;
+	return scope.Close(toObject());
+}
+
+void ProxyCensus::dump()
+{
+	pthread_mutex_lock(&registryMutex);
+	for (std::vector<Counters*>::iterator i = registry.begin(); i != registry.end(); ++i) {
+		Counters *counters = *i;
+		if (counters->created == 0 && counters->released == 0) {
+			continue;
+		}
+		LOGI(TAG, "%s: created=%d live=%d detached=%d reattached=%d released=%d",
+			counters->className.c_str(), counters->created, counters->live, counters->detached,
+			counters->reattached, counters->released);
+	}
+	pthread_mutex_unlock(&registryMutex);
+}
+
+} // namespace titanium
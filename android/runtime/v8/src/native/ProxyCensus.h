@@ -0,0 +1,59 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#ifndef TI_KROLL_PROXY_CENSUS_H
+#define TI_KROLL_PROXY_CENSUS_H
+
+#include <stdint.h>
+#include <string>
+#include <v8.h>
+
+namespace titanium {
+
+// Counts the lifecycle events of the native wrappers of each proxy
+// class. The counters are always on and updated atomically so they
+// can be read from any thread, including in release builds.
+class ProxyCensus
+{
+public:
+	struct Counters
+	{
+		std::string className;
+		volatile int32_t created;    // wrappers attached to a new Java object
+		volatile int32_t live;       // wrappers not deleted yet
+		volatile int32_t detached;   // Java references made weak
+		volatile int32_t reattached; // weak Java references made strong again
+		volatile int32_t released;   // wrappers deleted on a release from Java (V8Object.nativeRelease)
+	};
+
+	// Returns the counters of the class, created on first use.
+	// The counters live as long as the process.
+	static Counters* forClass(const char *className);
+
+	// Counters of the wrappers that are not proxies.
+	static Counters* defaultCounters();
+
+	static inline void increment(volatile int32_t &counter)
+	{
+		__sync_fetch_and_add(&counter, 1);
+	}
+
+	static inline void decrement(volatile int32_t &counter)
+	{
+		__sync_fetch_and_sub(&counter, 1);
+	}
+
+	// Returns an object with the counters of each class by class name.
+	static v8::Handle<v8::Object> toObject();
+	static v8::Handle<v8::Value> getProxyCensus(const v8::Arguments& args);
+
+	// Log the counters of every class with live wrappers or activity.
+	static void dump();
+};
+
+} // namespace titanium
+
+#endif
@@ -7,8 +7,9 @@
 
 #include "ProxyFactory.h"
 
-#include <map>
 #include <stdio.h>
+#include <string.h>
+#include <vector>
 #include <v8.h>
 
 #include "AndroidUtil.h"
@@ -26,40 +27,130 @@ using namespace v8;
 
 namespace titanium {
 
+// Registry of proxy classes. jclass values returned by separate
+// FindClass / GetObjectClass calls are not pointer stable, so entries
+// hold their own global ref and are keyed by the class' identity hash.
+// Each probe compares the hash first, then the reference itself, and
+// only falls back to IsSameObject() when the pointers differ.
+//
+// The hash takes a JNI upcall, so it is avoided where possible: Java
+// passes it along with the class to nativeInitObject(), and the
+// constructor of each registered proxy template carries its entry.
 typedef struct {
+	jclass javaClass;
+	jint classHash;
 	FunctionTemplate* v8ProxyTemplate;
+	Persistent<Function> v8ProxyCreator;
 	jmethodID javaProxyCreator;
 } ProxyInfo;
 
-typedef std::map<jclass, ProxyInfo> ProxyFactoryMap;
-static ProxyFactoryMap factories;
+typedef std::vector<ProxyInfo*> ProxyFactoryTable;
+static ProxyFactoryTable factories;
+static uint32_t factoryCount = 0;
 
-#define GET_PROXY_INFO(jclass, info) \
-	ProxyFactoryMap::iterator i = factories.find(jclass); \
-	info = i != factories.end() ? &i->second : NULL
+static ProxyFactory::Stats stats = { 0, 0, 0, 0 };
+
+// Property of a registered proxy template holding its ProxyInfo.
+static Persistent<String> proxyInfoSymbol;
+
+#define INITIAL_TABLE_CAPACITY 256
 
 #define LOG_JNIENV_ERROR(msgMore) \
 	LOGE(TAG, "Unable to find class %s", msgMore)
 
-Handle<Object> ProxyFactory::createV8Proxy(jclass javaClass, jobject javaProxy)
+static inline jint getClassHash(JNIEnv *env, jclass javaClass)
 {
-	LOGV(TAG, "create v8 proxy");
-	JNIEnv* env = JNIScope::getEnv();
-	if (!env) {
-		LOG_JNIENV_ERROR("while creating Java proxy.");
-		return Handle<Object>();
+	return env->CallStaticIntMethod(JNIUtil::systemClass,
+		JNIUtil::systemIdentityHashCodeMethod, javaClass);
+}
+
+static inline size_t getSlot(jint classHash, size_t mask)
+{
+	// Identity hashes are often sequential, spread them over the table.
+	return ((uint32_t) classHash * 2654435761U) & mask;
+}
+
+static ProxyInfo* findProxyInfo(JNIEnv *env, jclass javaClass, jint classHash)
+{
+	if (factories.empty()) {
+		return NULL;
 	}
 
-	ENTER_V8(V8Runtime::globalContext);
-	Local<Function> creator;
+	size_t mask = factories.size() - 1;
+	for (size_t i = getSlot(classHash, mask); factories[i]; i = (i + 1) & mask) {
+		ProxyInfo* info = factories[i];
+		if (info->classHash != classHash) {
+			continue;
+		}
+		if (info->javaClass == javaClass || env->IsSameObject(info->javaClass, javaClass)) {
+			return info;
+		}
+	}
 
-	LOGV(TAG, "get proxy info");
+	return NULL;
+}
+
+static void insertProxyInfo(ProxyInfo* info)
+{
+	size_t mask = factories.size() - 1;
+	size_t i = getSlot(info->classHash, mask);
+	while (factories[i]) {
+		i = (i + 1) & mask;
+	}
+	factories[i] = info;
+}
+
+// Returns the entry for the class, creating an empty one if needed.
+static ProxyInfo* getOrCreateProxyInfo(JNIEnv *env, jclass javaClass, jint classHash)
+{
+	ProxyInfo* info = findProxyInfo(env, javaClass, classHash);
+	if (info) {
+		return info;
+	}
+
+	// Keep the load factor at or below one half so probe chains stay short.
+	if ((factoryCount + 1) * 2 > factories.size()) {
+		ProxyFactoryTable old;
+		old.swap(factories);
+		factories.assign(old.empty() ? INITIAL_TABLE_CAPACITY : old.size() * 2, NULL);
+		for (ProxyFactoryTable::iterator i = old.begin(); i != old.end(); ++i) {
+			if (*i) {
+				insertProxyInfo(*i);
+			}
+		}
+	}
+
+	info = new ProxyInfo();
+	info->javaClass = (jclass) env->NewGlobalRef(javaClass);
+	info->classHash = classHash;
+	info->v8ProxyTemplate = NULL;
+	info->javaProxyCreator = JNIUtil::krollProxyCreateProxyMethod;
+
+	insertProxyInfo(info);
+	factoryCount++;
+	stats.entries = factoryCount;
+
+	return info;
+}
+
+static ProxyInfo* lookupProxyInfo(JNIEnv *env, jclass javaClass, jint classHash)
+{
+	stats.lookups++;
+	ProxyInfo* info = findProxyInfo(env, javaClass, classHash);
+	if (info) {
+		stats.hits++;
+	}
+	return info;
+}
+
+// Resolves and caches the V8 constructor for a class. The template of a
+// registered class is used directly, other classes go through the binding
+// lookup table once.
+static ProxyInfo* resolveProxyCreator(JNIEnv *env, jclass javaClass, jint classHash, ProxyInfo* info)
+{
+	if (!info || !info->v8ProxyTemplate) {
+		stats.misses++;
 
-	ProxyInfo* info;
-	GET_PROXY_INFO(javaClass, info);
-	if (!info) {
-		// No info has been registered for this class yet, fall back
-		// to the binding lookup table
 		jstring javaClassName = JNIUtil::getClassName(javaClass);
 		Handle<Value> className = TypeConverter::javaStringToJsString(env, javaClassName);
 		env->DeleteLocalRef(javaClassName);
@@ -69,23 +160,68 @@ Handle<Object> ProxyFactory::createV8Proxy(jclass javaClass, jobject javaProxy)
 		if (exports.IsEmpty()) {
 			String::Utf8Value classStr(className);
 			LOGE(TAG, "Failed to find class for %s", *classStr);
-			LOG_JNIENV_ERROR("while creating V8 Proxy.");
-			return Handle<Object>();
+			return NULL;
 		}
 
-		// TODO: The first value in exports should be the type that's exported
-		// But there's probably a better way to do this
-		Handle<Array> names = exports->GetPropertyNames();
-		if (names->Length() >= 1) {
-			creator = Local<Function>::Cast(exports->Get(names->Get(0)));
+		// Binding the exports normally registers the proxy pair for this class.
+		info = getOrCreateProxyInfo(env, javaClass, classHash);
+
+		if (!info->v8ProxyTemplate) {
+			// TODO: The first value in exports should be the type that's exported
+			// But there's probably a better way to do this
+			Handle<Array> names = exports->GetPropertyNames();
+			if (names->Length() < 1) {
+				return NULL;
+			}
+			Local<Function> creator = Local<Function>::Cast(exports->Get(names->Get(0)));
+			info->v8ProxyCreator = Persistent<Function>::New(creator);
+			return info;
+		}
+	}
+
+	// Instantiated lazily: the template is still being populated when
+	// registerProxyPair() is called.
+	info->v8ProxyCreator = Persistent<Function>::New(info->v8ProxyTemplate->GetFunction());
+	return info;
+}
+
+Handle<Object> ProxyFactory::createV8Proxy(jclass javaClass, jobject javaProxy)
+{
+	JNIEnv* env = JNIScope::getEnv();
+	if (!env) {
+		LOG_JNIENV_ERROR("while creating V8 proxy.");
+		return Handle<Object>();
+	}
+
+	return createV8Proxy(javaClass, javaProxy, getClassHash(env, javaClass));
+}
+
+Handle<Object> ProxyFactory::createV8Proxy(jclass javaClass, jobject javaProxy, jint classHash)
+{
+	LOGV(TAG, "create v8 proxy");
+	JNIEnv* env = JNIScope::getEnv();
+	if (!env) {
+		LOG_JNIENV_ERROR("while creating V8 proxy.");
+		return Handle<Object>();
+	}
+
+	ENTER_V8(V8Runtime::globalContext);
+
+	LOGV(TAG, "get proxy info");
+
+	ProxyInfo* info = lookupProxyInfo(env, javaClass, classHash);
+	if (!info || info->v8ProxyCreator.IsEmpty()) {
+		// No creator has been cached for this class yet
+		info = resolveProxyCreator(env, javaClass, classHash, info);
+		if (!info) {
+			LOG_JNIENV_ERROR("while creating V8 Proxy.");
+			return Handle<Object>();
 		}
-	} else {
-		creator = info->v8ProxyTemplate->GetFunction();
 	}
 
 	Local<Value> external = External::New(javaProxy);
 	TryCatch tryCatch;
-	Local<Object> v8Proxy = creator->NewInstance(1, &external);
+	Local<Object> v8Proxy = info->v8ProxyCreator->NewInstance(1, &external);
 	if (tryCatch.HasCaught()) {
 		LOGE(TAG, "Exception thrown while creating V8 proxy.");
 		V8Util::reportException(tryCatch);
@@ -103,13 +239,35 @@ Handle<Object> ProxyFactory::createV8Proxy(jclass javaClass, jobject javaProxy)
 		JNIUtil::krollProxyKrollObjectField, javaV8Object);
 	env->DeleteLocalRef(javaV8Object);
 
+	// Report memory the proxy acquired before it had a KrollObject.
+	jlong externalMemorySize = env->GetLongField(javaProxy,
+		JNIUtil::krollProxyExternalMemorySizeField);
+	if (externalMemorySize > 0) {
+		proxy->adjustExternalMemory(externalMemorySize);
+	}
+
 	return scope.Close(v8Proxy);
 }
 
-jobject ProxyFactory::createJavaProxy(jclass javaClass, Local<Object> v8Proxy, const Arguments& args)
+jobject ProxyFactory::createJavaProxy(jclass javaClass, Handle<Function> constructor,
+	Local<Object> v8Proxy, const Arguments& args)
 {
-	ProxyInfo* info;
-	GET_PROXY_INFO(javaClass, info);
+	JNIEnv* env = JNIScope::getEnv();
+	if (!env) {
+		LOG_JNIENV_ERROR("while creating Java proxy.");
+		return NULL;
+	}
+
+	ProxyInfo* info = NULL;
+	Local<Value> registered = proxyInfoSymbol.IsEmpty() ? Local<Value>() : constructor->Get(proxyInfoSymbol);
+	if (!registered.IsEmpty() && !registered->IsUndefined()) {
+		stats.lookups++;
+		stats.hits++;
+		info = static_cast<ProxyInfo*>(External::Unwrap(registered));
+	} else {
+		// Templates inherited from JS are not registered.
+		info = lookupProxyInfo(env, javaClass, getClassHash(env, javaClass));
+	}
 
 	if (!info) {
 		JNIUtil::logClassName("ProxyFactory: failed to find class for %s", javaClass, true);
@@ -117,12 +275,6 @@ jobject ProxyFactory::createJavaProxy(jclass javaClass, Local<Object> v8Proxy, c
 		return NULL;
 	}
 
-	JNIEnv* env = JNIScope::getEnv();
-	if (!env) {
-		LOG_JNIENV_ERROR("while creating Java proxy.");
-		return NULL;
-	}
-
 	// Create a persistent handle to the V8 proxy
 	// and cast it to a pointer. The Java proxy needs
 	// a reference to the V8 proxy for later use.
@@ -210,21 +362,67 @@ void ProxyFactory::registerProxyPair(jclass javaProxyClass, FunctionTemplate* v8
 		return;
 	}
 
-	ProxyInfo info;
-	info.v8ProxyTemplate = v8ProxyTemplate;
+	ProxyInfo* info = getOrCreateProxyInfo(env, javaProxyClass, getClassHash(env, javaProxyClass));
+	info->v8ProxyTemplate = v8ProxyTemplate;
+
+	if (proxyInfoSymbol.IsEmpty()) {
+		proxyInfoSymbol = SYMBOL_LITERAL("__proxyInfo__");
+	}
+	v8ProxyTemplate->Set(proxyInfoSymbol, External::Wrap(info), PropertyAttribute(DontDelete | DontEnum));
+
+	// Drop a creator resolved from the exports before this class was registered.
+	if (!info->v8ProxyCreator.IsEmpty()) {
+		info->v8ProxyCreator.Dispose();
+		info->v8ProxyCreator = Persistent<Function>();
+	}
 
 	if (createDeprecated) {
-		info.javaProxyCreator = JNIUtil::krollProxyCreateDeprecatedProxyMethod;
+		info->javaProxyCreator = JNIUtil::krollProxyCreateDeprecatedProxyMethod;
 	} else {
-		info.javaProxyCreator = JNIUtil::krollProxyCreateProxyMethod;
+		info->javaProxyCreator = JNIUtil::krollProxyCreateProxyMethod;
 	}
+}
 
-	factories[javaProxyClass] = info;
+void ProxyFactory::getStats(Stats *out)
+{
+	*out = stats;
+}
+
+void ProxyFactory::logStats()
+{
+	uint32_t hitRate = stats.lookups > 0 ? (uint32_t) (100ULL * stats.hits / stats.lookups) : 0;
+	LOGD(TAG, "Proxy class registry: %u classes, %u lookups, %u hits (%u%%), %u misses",
+		stats.entries, stats.lookups, stats.hits, hitRate, stats.misses);
 }
 
 void ProxyFactory::dispose()
 {
+	logStats();
+
+	JNIEnv* env = JNIScope::getEnv();
+	for (ProxyFactoryTable::iterator i = factories.begin(); i != factories.end(); ++i) {
+		ProxyInfo* info = *i;
+		if (!info) {
+			continue;
+		}
+
+		if (env) {
+			env->DeleteGlobalRef(info->javaClass);
+		}
+		if (!info->v8ProxyCreator.IsEmpty()) {
+			info->v8ProxyCreator.Dispose();
+		}
+		delete info;
+	}
+
 	factories.clear();
+	factoryCount = 0;
+
+	if (!proxyInfoSymbol.IsEmpty()) {
+		proxyInfoSymbol.Dispose();
+		proxyInfoSymbol = Persistent<String>();
+	}
+	memset(&stats, 0, sizeof(stats));
 }
 
 }
@@ -9,6 +9,7 @@
 #define PROXY_FACTORY_H
 
 #include <jni.h>
+#include <stdint.h>
 #include <v8.h>
 
 namespace titanium {
@@ -27,10 +28,16 @@ class ProxyFactory
 public:
 
 	// Creates a proxy on the V8 side given an existing Java proxy.
+	// classHash is System.identityHashCode() of the class, callers which
+	// have it at hand pass it to save the JNI upcall computing it.
 	static v8::Handle<v8::Object> createV8Proxy(jclass javaClass, jobject javaProxy);
+	static v8::Handle<v8::Object> createV8Proxy(jclass javaClass, jobject javaProxy, jint classHash);
 
 	// Creates a proxy on the Java side given an existing V8 proxy.
-	static jobject createJavaProxy(jclass javaClass, v8::Local<v8::Object> v8Proxy, const v8::Arguments& args);
+	// The constructor of a registered proxy class carries its registry
+	// entry, which saves the class lookup.
+	static jobject createJavaProxy(jclass javaClass, v8::Handle<v8::Function> constructor,
+		v8::Local<v8::Object> v8Proxy, const v8::Arguments& args);
 
 	// Used by createV8Proxy() which invokes the ProxyBinding::Constructor
 	// callback to create a new V8 object. We need a way to pass the Java proxy
@@ -44,6 +51,20 @@ public:
 	static v8::Handle<v8::Value> proxyConstructor(const v8::Arguments& args);
 
 	static void dispose();
+
+	// Counters for the class registry lookups done by createV8Proxy()
+	// and createJavaProxy(). A miss means the binding lookup table
+	// had to be consulted to resolve a V8 constructor.
+	struct Stats
+	{
+		uint32_t lookups;
+		uint32_t hits;
+		uint32_t misses;
+		uint32_t entries;
+	};
+
+	static void getStats(Stats *stats);
+	static void logStats();
 };
 
 }
@@ -5,55 +5,175 @@
  * Please see the LICENSE included with this distribution for details.
  */
 
+#include <stdint.h>
+#include <vector>
+
 #include "ReferenceTable.h"
 
+#include "AndroidUtil.h"
 #include "JNIUtil.h"
 
+#define TAG "ReferenceTable"
+
+#define INDEX_BITS 20
+#define INDEX_MASK ((1 << INDEX_BITS) - 1)
+#define GENERATION_MASK 0x7ff
+#define INITIAL_CAPACITY 256
+
 namespace titanium {
 
-jint ReferenceTable::createReference(jobject object)
+// The bookkeeping of a slot. The referenced object itself is stored at
+// the same index of a Java Object[], which only costs this table a
+// single global reference.
+struct Slot
+{
+	uint16_t generation;
+	bool weak; // the element is a WeakReference to the object
+	int32_t nextFree;
+};
+
+static std::vector<Slot> slots;
+static jobjectArray references = NULL;
+static jsize capacity = 0;
+static int32_t freeHead = -1;
+
+static bool ensureCapacity(JNIEnv *env)
+{
+	if ((jsize) slots.size() < capacity) {
+		return true;
+	}
+
+	jsize newCapacity = capacity ? capacity * 2 : INITIAL_CAPACITY;
+	jobjectArray array = env->NewObjectArray(newCapacity, JNIUtil::objectClass, NULL);
+	if (!array) {
+		return false;
+	}
+
+	// Only happens when the table doubles, the elements are moved one by one.
+	for (jsize i = 0; i < capacity; ++i) {
+		jobject element = env->GetObjectArrayElement(references, i);
+		if (element) {
+			env->SetObjectArrayElement(array, i, element);
+			env->DeleteLocalRef(element);
+		}
+	}
+
+	if (references) {
+		env->DeleteGlobalRef(references);
+	}
+	references = (jobjectArray) env->NewGlobalRef(array);
+	env->DeleteLocalRef(array);
+	capacity = newCapacity;
+	return true;
+}
+
+// Returns the slot index of a key, or -1 if the key is
+// invalid or its reference was already destroyed.
+static int32_t getIndex(jint key)
+{
+	int32_t index = (key & INDEX_MASK) - 1;
+	if (index < 0 || index >= (int32_t) slots.size()) {
+		return -1;
+	}
+	if (slots[index].generation != ((uint32_t) key >> INDEX_BITS)) {
+		return -1;
+	}
+	return index;
+}
+
+// Returns a local reference to the object of a slot,
+// or NULL if a weak reference was cleared.
+static jobject getObject(JNIEnv *env, int32_t index)
 {
-	JNIEnv* env = JNIUtil::getJNIEnv();
-	return env->CallStaticIntMethod(
-		JNIUtil::referenceTableClass,
-		JNIUtil::referenceTableCreateReferenceMethod,
-		object);
+	jobject element = env->GetObjectArrayElement(references, index);
+	if (!element || !slots[index].weak) {
+		return element;
+	}
+
+	jobject object = env->CallObjectMethod(element, JNIUtil::weakReferenceGetMethod);
+	env->DeleteLocalRef(element);
+	return object;
 }
 
-void ReferenceTable::destroyReference(jint key)
+jint ReferenceTable::createReference(JNIEnv *env, jobject object)
 {
-	JNIEnv* env = JNIUtil::getJNIEnv();
-	env->CallStaticVoidMethod(
-		JNIUtil::referenceTableClass,
-		JNIUtil::referenceTableDestroyReferenceMethod,
-		key);
+	int32_t index = freeHead;
+	if (index >= 0) {
+		freeHead = slots[index].nextFree;
+	} else {
+		if (slots.size() == INDEX_MASK) {
+			LOGE(TAG, "Reference table is full");
+			return 0;
+		}
+		if (!ensureCapacity(env)) {
+			return 0;
+		}
+		Slot slot = { 0, false, -1 };
+		slots.push_back(slot);
+		index = slots.size() - 1;
+	}
+
+	env->SetObjectArrayElement(references, index, object);
+	slots[index].weak = false;
+
+	// Keys are always positive, index 0 is stored as 1.
+	return (slots[index].generation << INDEX_BITS) | (index + 1);
 }
 
-void ReferenceTable::makeWeakReference(jint key)
+void ReferenceTable::destroyReference(JNIEnv *env, jint key)
 {
-	JNIEnv* env = JNIUtil::getJNIEnv();
-	env->CallStaticVoidMethod(
-		JNIUtil::referenceTableClass,
-		JNIUtil::referenceTableMakeWeakReferenceMethod,
-		key);
+	int32_t index = getIndex(key);
+	if (index < 0) {
+		return;
+	}
+
+	env->SetObjectArrayElement(references, index, NULL);
+
+	Slot &slot = slots[index];
+	slot.generation = (slot.generation + 1) & GENERATION_MASK;
+	slot.weak = false;
+	slot.nextFree = freeHead;
+	freeHead = index;
 }
 
-jobject ReferenceTable::clearWeakReference(jint key)
+void ReferenceTable::makeWeakReference(JNIEnv *env, jint key)
 {
-	JNIEnv* env = JNIUtil::getJNIEnv();
-	return env->CallStaticObjectMethod(
-		JNIUtil::referenceTableClass,
-		JNIUtil::referenceTableClearWeakReferenceMethod,
-		key);
+	int32_t index = getIndex(key);
+	if (index < 0 || slots[index].weak) {
+		return;
+	}
+
+	jobject object = env->GetObjectArrayElement(references, index);
+	jobject weakReference = env->NewObject(JNIUtil::weakReferenceClass, JNIUtil::weakReferenceInitMethod, object);
+	env->SetObjectArrayElement(references, index, weakReference);
+	slots[index].weak = true;
+
+	env->DeleteLocalRef(weakReference);
+	env->DeleteLocalRef(object);
+}
+
+jobject ReferenceTable::clearWeakReference(JNIEnv *env, jint key)
+{
+	int32_t index = getIndex(key);
+	if (index < 0) {
+		return NULL;
+	}
+
+	jobject object = getObject(env, index);
+	if (slots[index].weak) {
+		env->SetObjectArrayElement(references, index, object);
+		slots[index].weak = false;
+	}
+	return object;
 }
 
-jobject ReferenceTable::getReference(jint key)
+jobject ReferenceTable::getReference(JNIEnv *env, jint key)
 {
-	JNIEnv* env = JNIUtil::getJNIEnv();
-	return env->CallStaticObjectMethod(
-		JNIUtil::referenceTableClass,
-		JNIUtil::referenceTableGetReferenceMethod,
-		key);
+	int32_t index = getIndex(key);
+	if (index < 0) {
+		return NULL;
+	}
+	return getObject(env, index);
 }
 
 } // namespace titanium
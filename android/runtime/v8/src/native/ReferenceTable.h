@@ -17,18 +17,28 @@ namespace titanium {
  * of this is to workaround JNI global reference limits
  * put in place on certain devices (ex: emulator).
  * It is implemented by placing the referenced
- * objects into a container (HashMap) and accessing
- * them later by an unique integer key. See
- * ReferenceTable.java in kroll-v8 project.
+ * objects into a slab of slots and accessing
+ * them later by an unique integer key. Keys are
+ * always positive and a destroyed key never resolves
+ * again.
+ *
+ * The slots are managed natively. The objects are the
+ * elements of a single Java Object[] held by one global
+ * reference, and are read and written with the JNI array
+ * functions instead of calls into Java. Weak references
+ * are java.lang.ref.WeakReference elements.
+ *
+ * Only used on the KrollRuntime thread, there is no locking.
  */
 class ReferenceTable
 {
 public:
-	static jint createReference(jobject object);
-	static void destroyReference(jint key);
-	static void makeWeakReference(jint key);
-	static jobject clearWeakReference(jint key);
-	static jobject getReference(jint key);
+	// Callers pass the JNIEnv they already hold, see JNIScope::getEnv().
+	static jint createReference(JNIEnv *env, jobject object);
+	static void destroyReference(JNIEnv *env, jint key);
+	static void makeWeakReference(JNIEnv *env, jint key);
+	static jobject clearWeakReference(JNIEnv *env, jint key);
+	static jobject getReference(JNIEnv *env, jint key);
 };
 
 } // namespace titanium
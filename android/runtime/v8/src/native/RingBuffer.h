@@ -0,0 +1,116 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <stdint.h>
+
+namespace titanium {
+
+// A fixed size queue with many producers and a single consumer.
+// Producers push from any thread without taking a lock, the consumer
+// pops from one thread at a time. Capacity must be a power of two.
+//
+// A cell is free for the producer claiming position p when its sequence
+// is p, and holds a published item for the consumer at p when it is p + 1.
+template <typename T, uint32_t Capacity>
+class RingBuffer
+{
+public:
+	RingBuffer()
+	{
+		reset();
+	}
+
+	// Empties the queue. Must not race with push() or pop().
+	void reset()
+	{
+		enqueuePosition = 0;
+		dequeuePosition = 0;
+		for (uint32_t i = 0; i < Capacity; i++) {
+			cells[i].sequence = i;
+		}
+		__sync_synchronize();
+	}
+
+	// Returns false if the queue is full.
+	bool push(const T& item)
+	{
+		uint32_t position = enqueuePosition;
+		Cell *cell;
+
+		for (;;) {
+			cell = &cells[position & (Capacity - 1)];
+			int32_t difference = (int32_t) (cell->sequence - position);
+
+			if (difference == 0) {
+				if (__sync_bool_compare_and_swap(&enqueuePosition, position, position + 1)) {
+					break;
+				}
+				position = enqueuePosition;
+			} else if (difference < 0) {
+				// the consumer has not freed this cell yet, the queue is full
+				return false;
+			} else {
+				position = enqueuePosition;
+			}
+		}
+
+		cell->item = item;
+		__sync_synchronize();
+		cell->sequence = position + 1;
+		return true;
+	}
+
+	// Returns false if the queue is empty, or if the next item
+	// is claimed by a producer which has not published it yet.
+	bool pop(T *item)
+	{
+		Cell *cell = &cells[dequeuePosition & (Capacity - 1)];
+		if (cell->sequence != dequeuePosition + 1) {
+			return false;
+		}
+		__sync_synchronize();
+
+		*item = cell->item;
+		__sync_synchronize();
+		cell->sequence = dequeuePosition + Capacity;
+		dequeuePosition++;
+		return true;
+	}
+
+	// Same as pop(), but only returns items pushed before
+	// the consumer took the batch mark with pushed().
+	bool pop(T *item, uint32_t mark)
+	{
+		if ((int32_t) (mark - dequeuePosition) <= 0) {
+			return false;
+		}
+		return pop(item);
+	}
+
+	// The number of positions claimed by producers so far.
+	uint32_t pushed() const
+	{
+		return enqueuePosition;
+	}
+
+private:
+	struct Cell
+	{
+		volatile uint32_t sequence;
+		T item;
+	};
+
+	Cell cells[Capacity];
+	volatile uint32_t enqueuePosition;
+	uint32_t dequeuePosition; // only used by the consumer
+};
+
+} // namespace titanium
+
+#endif
@@ -772,8 +772,14 @@ jobject TypeConverter::jsValueToJavaError(JNIEnv *env, v8::Local<v8::Value> jsVa
 v8::Handle<v8::Object> TypeConverter::javaHashMapToJsValue(JNIEnv *env, jobject javaObject)
 {
 	v8::Handle<v8::Object> jsObject = v8::Object::New();
+	javaHashMapToJsObject(env, javaObject, jsObject);
+	return jsObject;
+}
+
+void TypeConverter::javaHashMapToJsObject(JNIEnv *env, jobject javaObject, v8::Handle<v8::Object> jsObject)
+{
 	if (!javaObject || !env) {
-		return jsObject;
+		return;
 	}
 
 	jobject hashMapSet = env->CallObjectMethod(javaObject, JNIUtil::hashMapKeySetMethod);
@@ -804,8 +810,6 @@ v8::Handle<v8::Object> TypeConverter::javaHashMapToJsValue(JNIEnv *env, jobject
 	}
 
 	env->DeleteLocalRef(hashMapKeys);
-
-	return jsObject;
 }
 
 // converts java object to js value and recursively converts sub objects if this
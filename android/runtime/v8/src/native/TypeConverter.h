@@ -173,6 +173,8 @@ public:
 	static jobject jsValueToJavaError(JNIEnv *env, v8::Local<v8::Value> jsValue, bool *isNew);
 	static jobject jsValueToJavaObject(JNIEnv *env, v8::Local<v8::Value> jsValue, bool *isNew);
 	static v8::Handle<v8::Object> javaHashMapToJsValue(JNIEnv *env, jobject javaObject);
+	// Copies the entries of the HashMap into an existing object.
+	static void javaHashMapToJsObject(JNIEnv *env, jobject javaObject, v8::Handle<v8::Object> jsObject);
 	static v8::Handle<v8::Value> javaObjectToJsValue(JNIEnv *env, jobject javaObject);
 	static jobject jsObjectToJavaKrollDict(JNIEnv *env, v8::Local<v8::Value> jsValue, bool *isNew);
 
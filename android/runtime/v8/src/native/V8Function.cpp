@@ -8,16 +8,74 @@
 #include <jni.h>
 #include <v8.h>
 
+#include "CallQueue.h"
 #include "JNIUtil.h"
 #include "TypeConverter.h"
 #include "V8Runtime.h"
 #include "V8Util.h"
 
+#include "V8Function.h"
+
 #define TAG "V8Function"
 
 using namespace titanium;
 using namespace v8;
 
+// Arguments up to this count are converted into an array on the stack.
+#define MAX_STACK_ARGUMENTS 8
+
+namespace titanium {
+
+jobject V8Function::invoke(JNIEnv *env, jlong thisPointer, jlong functionPointer,
+	int argc, Handle<Value> *argv)
+{
+	Local<Object> thisObject = Local<Object>((Object *) thisPointer);
+
+	// construct function from pointer
+	Function *jsFunction = (Function *) functionPointer;
+
+	// call into the JS function with the provided arguments
+	TryCatch tryCatch;
+	Local<Value> object = jsFunction->Call(thisObject, argc, argv);
+
+	if (tryCatch.HasCaught()) {
+		V8Util::openJSErrorDialog(tryCatch);
+		V8Util::reportException(tryCatch);
+
+		return NULL;
+	}
+
+	bool isNew;
+	return TypeConverter::jsValueToJavaObject(env, object, &isNew);
+}
+
+jobject V8Function::invoke(JNIEnv *env, jlong thisPointer, jlong functionPointer, jobjectArray functionArguments)
+{
+	// create function arguments, on the heap only for long argument lists
+	jsize length = functionArguments ? env->GetArrayLength(functionArguments) : 0;
+	Handle<Value> stackArguments[MAX_STACK_ARGUMENTS];
+	Handle<Value> *jsFunctionArguments = stackArguments;
+	if (length > MAX_STACK_ARGUMENTS) {
+		jsFunctionArguments = new Handle<Value>[length];
+	}
+
+	for (jsize i = 0; i < length; i++) {
+		jobject arrayElement = env->GetObjectArrayElement(functionArguments, i);
+		jsFunctionArguments[i] = TypeConverter::javaObjectToJsValue(env, arrayElement);
+		env->DeleteLocalRef(arrayElement);
+	}
+
+	jobject result = invoke(env, thisPointer, functionPointer, length, jsFunctionArguments);
+
+	if (jsFunctionArguments != stackArguments) {
+		delete[] jsFunctionArguments;
+	}
+
+	return result;
+}
+
+} // namespace titanium
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -25,7 +83,7 @@ extern "C" {
 /*
  * Class:     org_appcelerator_kroll_runtime_v8_V8Function
  * Method:    nativeInvoke
- * Signature: (JJ[Ljava/lang/Object)V
+ * Signature: (JJ[Ljava/lang/Object;)Ljava/lang/Object;
  */
 JNIEXPORT jobject JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Function_nativeInvoke(
 	JNIEnv *env, jobject caller, jlong thisPointer, jlong functionPointer, jobjectArray functionArguments)
@@ -33,34 +91,72 @@ JNIEXPORT jobject JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Function_nati
 	ENTER_V8(V8Runtime::globalContext);
 	titanium::JNIScope jniScope(env);
 
-	Local<Object> thisObject = Local<Object>((Object *) thisPointer);
+	return V8Function::invoke(env, thisPointer, functionPointer, functionArguments);
+}
 
-	// construct function from pointer
-	Function *jsFunction = (Function *) functionPointer;
+/*
+ * Class:     org_appcelerator_kroll_runtime_v8_V8Function
+ * Method:    nativeInvokeMap
+ * Signature: (JJLjava/util/HashMap;)Ljava/lang/Object;
+ */
+JNIEXPORT jobject JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Function_nativeInvokeMap(
+	JNIEnv *env, jobject caller, jlong thisPointer, jlong functionPointer, jobject functionArgument)
+{
+	ENTER_V8(V8Runtime::globalContext);
+	titanium::JNIScope jniScope(env);
 
-	// create function arguments
-	int length;
-	v8::Handle<v8::Value> *jsFunctionArguments =
-		TypeConverter::javaObjectArrayToJsArguments(env, functionArguments, &length);
+	v8::Handle<v8::Value> jsFunctionArguments[1];
+	if (functionArgument) {
+		jsFunctionArguments[0] = TypeConverter::javaHashMapToJsValue(env, functionArgument);
+	} else {
+		jsFunctionArguments[0] = v8::Null();
+	}
 
-	// call into the JS function with the provided argument
-	TryCatch tryCatch;
-	v8::Local<v8::Value> object = jsFunction->Call(thisObject, length, jsFunctionArguments);
+	return V8Function::invoke(env, thisPointer, functionPointer, 1, jsFunctionArguments);
+}
 
-	// make sure to delete the arguments since the arguments array is built on the heap
-	if (jsFunctionArguments) {
-		delete jsFunctionArguments;
-	}
+/*
+ * Class:     org_appcelerator_kroll_runtime_v8_V8Function
+ * Method:    nativeQueueCall
+ * Signature: (Lorg/appcelerator/kroll/runtime/v8/V8Function;Lorg/appcelerator/kroll/KrollObject;[Ljava/lang/Object;)Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Function_nativeQueueCall(
+	JNIEnv *env, jclass clazz, jobject function, jobject thisObject, jobjectArray functionArguments)
+{
+	return CallQueue::post(env, function, thisObject, functionArguments);
+}
 
-	if (tryCatch.HasCaught()) {
-		V8Util::openJSErrorDialog(tryCatch);
-		V8Util::reportException(tryCatch);
+/*
+ * Class:     org_appcelerator_kroll_runtime_v8_V8Function
+ * Method:    nativeQueueBlockingCall
+ * Signature: (Lorg/appcelerator/kroll/runtime/v8/V8Function;Lorg/appcelerator/kroll/KrollObject;[Ljava/lang/Object;)J
+ */
+JNIEXPORT jlong JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Function_nativeQueueBlockingCall(
+	JNIEnv *env, jclass clazz, jobject function, jobject thisObject, jobjectArray functionArguments)
+{
+	return (jlong) CallQueue::postBlocking(env, function, thisObject, functionArguments);
+}
 
-		return NULL;
-	}
-	
-	bool isNew;
-	return TypeConverter::jsValueToJavaObject(env, object, &isNew);
+/*
+ * Class:     org_appcelerator_kroll_runtime_v8_V8Function
+ * Method:    nativeAwaitCall
+ * Signature: (JI)Z
+ */
+JNIEXPORT jboolean JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Function_nativeAwaitCall(
+	JNIEnv *env, jclass clazz, jlong completion, jint timeout)
+{
+	return CallQueue::await((CallQueue::Completion *) completion, timeout);
+}
+
+/*
+ * Class:     org_appcelerator_kroll_runtime_v8_V8Function
+ * Method:    nativeFinishCall
+ * Signature: (J)Ljava/lang/Object;
+ */
+JNIEXPORT jobject JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Function_nativeFinishCall(
+	JNIEnv *env, jclass clazz, jlong completion)
+{
+	return CallQueue::finish(env, (CallQueue::Completion *) completion);
 }
 
 JNIEXPORT void JNICALL
@@ -0,0 +1,30 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#ifndef V8_FUNCTION_H
+#define V8_FUNCTION_H
+
+#include <jni.h>
+#include <v8.h>
+
+namespace titanium {
+
+class V8Function
+{
+public:
+	// Calls the function with arguments already converted to JS values and
+	// returns the result converted to Java. Returns NULL if the function threw,
+	// the exception has then been reported.
+	static jobject invoke(JNIEnv *env, jlong thisPointer, jlong functionPointer,
+		int argc, v8::Handle<v8::Value> *argv);
+
+	// Converts the Java arguments, which may be NULL, and calls the function.
+	static jobject invoke(JNIEnv *env, jlong thisPointer, jlong functionPointer, jobjectArray functionArguments);
+};
+
+} // namespace titanium
+
+#endif
@@ -30,12 +30,12 @@ extern "C" {
 
 JNIEXPORT void JNICALL
 Java_org_appcelerator_kroll_runtime_v8_V8Object_nativeInitObject
-	(JNIEnv *env, jclass clazz, jclass proxyClass, jobject proxyObject)
+	(JNIEnv *env, jclass clazz, jclass proxyClass, jint proxyClassHash, jobject proxyObject)
 {
 	ENTER_V8(V8Runtime::globalContext);
 	JNIScope jniScope(env);
 
-	ProxyFactory::createV8Proxy(proxyClass, proxyObject);
+	ProxyFactory::createV8Proxy(proxyClass, proxyObject, proxyClassHash);
 }
 
 JNIEXPORT void JNICALL
@@ -81,11 +81,6 @@ Java_org_appcelerator_kroll_runtime_v8_V8Object_nativeFireEvent
 		emitter = TypeConverter::javaObjectToJsValue(env, jEmitter)->ToObject();
 	}
 
-	Handle<Value> fireEventValue = emitter->Get(EventEmitter::emitSymbol);
-	if (!fireEventValue->IsFunction()) {
-		return JNI_FALSE;
-	}
-
 	Handle<Object> source;
 	if ((jsource == NULL) || (jsource == jEmitter)) {
 		source = emitter;
@@ -95,27 +90,28 @@ Java_org_appcelerator_kroll_runtime_v8_V8Object_nativeFireEvent
 		source = TypeConverter::javaObjectToJsValue(env, jsource)->ToObject();
 	}
 
-	Handle<Function> fireEvent = Handle<Function>::Cast(fireEventValue->ToObject());
-
-	Handle<Object> jsData = TypeConverter::javaHashMapToJsValue(env, data);
+	// The event object is the only allocation, it is handed to the
+	// listeners as is. The event data may override the type, the standard
+	// fields set afterwards take precedence over the data.
+	Local<Object> jsData = EventEmitter::newEventObject();
+	jsData->Set(EventEmitter::typeSymbol, jsEvent);
+	TypeConverter::javaHashMapToJsObject(env, data, jsData);
 
-	jsData->Set(String::NewSymbol("bubbles"), TypeConverter::javaBooleanToJsBoolean(bubble));
-
-	jsData->Set(String::NewSymbol("source"), source);
+	jsData->Set(EventEmitter::bubblesSymbol, TypeConverter::javaBooleanToJsBoolean(bubble));
+	jsData->Set(EventEmitter::sourceSymbol, source);
 
 	if (reportSuccess || code != 0) {
-		jsData->Set(String::NewSymbol("success"), TypeConverter::javaBooleanToJsBoolean(code == 0));
-		jsData->Set(String::NewSymbol("code"), TypeConverter::javaIntToJsNumber(code));
+		jsData->Set(EventEmitter::successSymbol, TypeConverter::javaBooleanToJsBoolean(code == 0));
+		jsData->Set(EventEmitter::codeSymbol, TypeConverter::javaIntToJsNumber(code));
 	}
-	
+
 	if (errorMessage != NULL) {
-		jsData->Set(String::NewSymbol("error"), TypeConverter::javaStringToJsString(env, errorMessage));
+		jsData->Set(EventEmitter::errorSymbol, TypeConverter::javaStringToJsString(env, errorMessage));
 	}
 
 	Handle<Value> result;
 	TryCatch tryCatch;
-	Handle<Value> args[] = { jsEvent, jsData };
-	result = fireEvent->Call(emitter, 2, args);
+	result = EventEmitter::fireEvent(emitter, jsEvent, jsData);
 
 	if (tryCatch.HasCaught()) {
 		V8Util::openJSErrorDialog(tryCatch);
@@ -173,8 +169,14 @@ Java_org_appcelerator_kroll_runtime_v8_V8Object_nativeRelease
 
 	if (refPointer) {
 		Persistent<Object> handle((Object *)refPointer);
+		if (handle->InternalFieldCount() == 0) {
+			// not a wrapper (ex: a function), nothing to release here
+			return false;
+		}
+
 		JavaObject *javaObject = NativeObject::Unwrap<JavaObject>(handle);
 		if (javaObject && javaObject->isDetached()) {
+			ProxyCensus::increment(javaObject->census()->released);
 			delete javaObject;
 			return true;
 		}
@@ -183,6 +185,47 @@ Java_org_appcelerator_kroll_runtime_v8_V8Object_nativeRelease
 	return false;
 }
 
+// Releases a batch of objects with a single entry into V8. The pointer
+// of every wrapper that was deleted is set to 0 in the array, the others
+// are still attached to their Java object. Returns the number deleted.
+JNIEXPORT jint JNICALL
+Java_org_appcelerator_kroll_runtime_v8_V8Object_nativeReleaseMany
+	(JNIEnv *env, jclass clazz, jlongArray refPointers)
+{
+	ENTER_V8(V8Runtime::globalContext);
+	JNIScope jniScope(env);
+
+	jsize length = env->GetArrayLength(refPointers);
+	jlong *pointers = env->GetLongArrayElements(refPointers, NULL);
+	jint freed = 0;
+
+	for (jsize i = 0; i < length; ++i) {
+		if (!pointers[i]) {
+			continue;
+		}
+
+		Persistent<Object> handle((Object *)pointers[i]);
+		if (handle->InternalFieldCount() == 0) {
+			continue;
+		}
+
+		JavaObject *javaObject = NativeObject::Unwrap<JavaObject>(handle);
+		if (!javaObject) {
+			continue;
+		}
+
+		if (javaObject->isDetached()) {
+			ProxyCensus::increment(javaObject->census()->released);
+			delete javaObject;
+			pointers[i] = 0;
+			freed++;
+		}
+	}
+
+	env->ReleaseLongArrayElements(refPointers, pointers, 0);
+	return freed;
+}
+
 JNIEXPORT void JNICALL
 Java_org_appcelerator_kroll_runtime_v8_V8Object_nativeSetWindow
 	(JNIEnv *env, jobject javaKrollWindow, jlong ptr, jobject javaWindow)
@@ -218,6 +261,86 @@ Java_org_appcelerator_kroll_runtime_v8_V8Object_nativeSetWindow
 	}
 }
 
+JNIEXPORT void JNICALL
+Java_org_appcelerator_kroll_runtime_v8_V8Object_nativeSetExternalArrayData
+	(JNIEnv *env, jobject javaObject, jlong ptr, jobject buffer)
+{
+	ENTER_V8(V8Runtime::globalContext);
+	titanium::JNIScope jniScope(env);
+
+	Handle<Object> jsObject;
+	if (ptr != 0) {
+		jsObject = Persistent<Object>((Object *) ptr);
+	} else {
+		jsObject = TypeConverter::javaObjectToJsValue(env, javaObject)->ToObject();
+	}
+
+	void *data = env->GetDirectBufferAddress(buffer);
+	jlong length = env->GetDirectBufferCapacity(buffer);
+	if (data == NULL || length < 0) {
+		LOGE(TAG, "Unable to set external array data: buffer is not a direct buffer");
+		return;
+	}
+
+	// V8 requires a valid pointer even for an empty array.
+	static uint8_t emptyData;
+	if (length == 0) {
+		data = &emptyData;
+	}
+
+	// The Java proxy owns the buffer and outlives the JS object's access to it,
+	// so no reference to the buffer is kept here.
+	jsObject->SetIndexedPropertiesToExternalArrayData(data, kExternalUnsignedByteArray, (int) length);
+}
+
+JNIEXPORT void JNICALL
+Java_org_appcelerator_kroll_runtime_v8_V8Object_nativeSetBubbleParent
+	(JNIEnv *env, jobject javaObject, jlong ptr, jlong parentPtr, jboolean linked)
+{
+	ENTER_V8(V8Runtime::globalContext);
+	titanium::JNIScope jniScope(env);
+
+	Handle<Object> jsObject = Persistent<Object>((Object *) ptr);
+	EventEmitter *emitter = NativeObject::Unwrap<EventEmitter>(jsObject);
+	if (!emitter) {
+		return;
+	}
+
+	if (!linked) {
+		emitter->unlinkBubbleParent();
+		return;
+	}
+
+	Handle<Object> parent;
+	if (parentPtr != 0) {
+		parent = Persistent<Object>((Object *) parentPtr);
+	}
+	emitter->setBubbleParent(parent);
+}
+
+JNIEXPORT void JNICALL
+Java_org_appcelerator_kroll_runtime_v8_V8Object_nativeAdjustExternalMemory
+	(JNIEnv *env, jobject javaObject, jlong ptr, jlong bytes)
+{
+	ENTER_V8(V8Runtime::globalContext);
+	titanium::JNIScope jniScope(env);
+
+	Handle<Object> jsObject;
+	if (ptr != 0) {
+		jsObject = Persistent<Object>((Object *) ptr);
+	} else {
+		jsObject = TypeConverter::javaObjectToJsValue(env, javaObject)->ToObject();
+	}
+
+	JavaObject *nativeObject = NativeObject::Unwrap<JavaObject>(jsObject);
+	if (!nativeObject) {
+		LOGE(TAG, "Unable to adjust external memory: object is not a Java object");
+		return;
+	}
+
+	nativeObject->adjustExternalMemory(bytes);
+}
+
 #ifdef __cplusplus
 }
 #endif
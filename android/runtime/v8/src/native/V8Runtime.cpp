@@ -5,21 +5,30 @@
  * Please see the LICENSE included with this distribution for details.
  */
 #include <jni.h>
+#include <limits.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include <v8.h>
 #include <v8-debug.h>
 
 #include "AndroidUtil.h"
+#include "AsyncMethod.h"
+#include "CallQueue.h"
 #include "EventEmitter.h"
+#include "EventQueue.h"
+#include "IdleScheduler.h"
 #include "JavaObject.h"
 #include "JNIUtil.h"
 #include "JSException.h"
 #include "KrollBindings.h"
+#include "Profiler.h"
+#include "ProxyCensus.h"
 #include "ProxyFactory.h"
 #include "ScriptsModule.h"
 #include "TypeConverter.h"
 #include "V8Util.h"
+#include "WrapperPool.h"
 
 #include "V8Runtime.h"
 
@@ -30,6 +39,10 @@
 // The port number on which the V8 debugger will listen on.
 #define V8_DEBUGGER_PORT 9999
 
+// Same value as ComponentCallbacks2.TRIM_MEMORY_BACKGROUND. From this
+// level on the process is in the background LRU list and may be killed.
+#define TRIM_MEMORY_BACKGROUND 40
+
 namespace titanium {
 
 Persistent<Context> V8Runtime::globalContext;
@@ -121,20 +134,31 @@ static void logV8Exception(Handle<Message> msg, Handle<Value> data)
 		*String::Utf8Value(msg->GetScriptResourceName()),
 		msg->GetLineNumber(),
 		*String::Utf8Value(msg->GetSourceLine()));
+
+	// No data is registered with the listener, V8 passes the exception instead.
+	JSException::logJavaStack(data);
 }
 
 static jmethodID dispatchDebugMessage = NULL;
 
 static void dispatchHandler()
 {
-	static JNIEnv *env = NULL;
+	// Called on the debugger agent thread, which is attached on first use.
+	JNIEnv *env = JNIUtil::getJNIEnv();
 	if (!env) {
-		titanium::JNIUtil::javaVm->AttachCurrentThread(&env, NULL);
+		return;
 	}
 
 	env->CallVoidMethod(V8Runtime::javaInstance, dispatchDebugMessage);
 }
 
+// Converts a heap limit from megabytes to the bytes V8 takes, clamped to an int.
+static int heapLimitInBytes(jint megabytes)
+{
+	int64_t bytes = (int64_t) megabytes * 1024 * 1024;
+	return bytes > INT_MAX ? INT_MAX : (int) bytes;
+}
+
 } // namespace titanium
 
 #ifdef __cplusplus
@@ -148,7 +172,7 @@ using namespace titanium;
  * Method:    nativeInit
  * Signature: (Lorg/appcelerator/kroll/runtime/v8/V8Runtime;)J
  */
-JNIEXPORT void JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Runtime_nativeInit(JNIEnv *env, jobject self, jboolean useGlobalRefs, jint debuggerPort, jboolean DBG, jboolean profilerEnabled)
+JNIEXPORT void JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Runtime_nativeInit(JNIEnv *env, jobject self, jboolean useGlobalRefs, jint debuggerPort, jboolean DBG, jboolean profilerEnabled, jboolean profilingEnabled, jint maxYoungSpaceSize, jint maxOldSpaceSize)
 {
 	if (profilerEnabled) {
 		char* argv[] = { const_cast<char*>(""), const_cast<char*>("--expose-gc") };
@@ -156,6 +180,22 @@ JNIEXPORT void JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Runtime_nativeIn
 		V8::SetFlagsFromCommandLine(&argc, argv, false);
 	}
 
+	// Heap limits (in megabytes) must be set before the heap is created,
+	// they are kept by V8 when the runtime is relaunched. V8 takes them
+	// in bytes as an int, larger values are clamped.
+	if (maxYoungSpaceSize > 0 || maxOldSpaceSize > 0) {
+		ResourceConstraints constraints;
+		if (maxYoungSpaceSize > 0) {
+			constraints.set_max_young_space_size(heapLimitInBytes(maxYoungSpaceSize));
+		}
+		if (maxOldSpaceSize > 0) {
+			constraints.set_max_old_space_size(heapLimitInBytes(maxOldSpaceSize));
+		}
+		if (!SetResourceConstraints(&constraints)) {
+			LOGW(TAG, "Unable to set the JavaScript heap limits, the heap is already initialized.");
+		}
+	}
+
 	HandleScope scope;
 	titanium::JNIScope jniScope(env);
 
@@ -164,8 +204,10 @@ JNIEXPORT void JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Runtime_nativeIn
 	V8::SetCaptureStackTraceForUncaughtExceptions(true);
 
 	JavaObject::useGlobalRefs = useGlobalRefs;
+	JavaObject::initGCCallbacks();
 	V8Runtime::debuggerEnabled = debuggerPort >= 0;
 	V8Runtime::DBG = DBG;
+	Profiler::enabled = DBG || profilingEnabled;
 
 	V8Runtime::javaInstance = env->NewGlobalRef(self);
 	JNIUtil::initCache();
@@ -176,6 +218,9 @@ JNIEXPORT void JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Runtime_nativeIn
 	V8Runtime::globalContext = context;
 	V8Runtime::bootstrap(context->Global());
 
+	CallQueue::init();
+	AsyncMethod::init();
+
 	if (V8Runtime::debuggerEnabled) {
 		jclass v8RuntimeClass = env->FindClass("org/appcelerator/kroll/runtime/v8/V8Runtime");
 		dispatchDebugMessage = env->GetMethodID(v8RuntimeClass, "dispatchDebugMessages", "()V");
@@ -256,9 +301,121 @@ JNIEXPORT void JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Runtime_nativePr
 	v8::Debug::ProcessDebugMessages();
 }
 
-JNIEXPORT jboolean JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Runtime_nativeIdle(JNIEnv *env, jobject self)
+JNIEXPORT jboolean JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Runtime_nativeIdle(JNIEnv *env, jobject self, jint budget, jboolean force)
 {
-	return v8::V8::IdleNotification();
+	return IdleScheduler::idle(budget, force);
+}
+
+// Called when Android reports the process is running low on memory or is
+// in the background. Releases what the runtime can rebuild on demand, then
+// lets V8 collect all available garbage and drop its compilation cache.
+JNIEXPORT void JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Runtime_nativeLowMemory(JNIEnv *env, jobject self, jint level)
+{
+	ENTER_V8(V8Runtime::globalContext);
+	titanium::JNIScope jniScope(env);
+
+	if (level >= TRIM_MEMORY_BACKGROUND && !moduleObject.IsEmpty()) {
+		// Drop the cached exports of modules marked as disposable,
+		// they are evaluated again on the next require().
+		Handle<Value> trimCache = moduleObject->Get(String::NewSymbol("trimCache"));
+		if (trimCache->IsFunction()) {
+			TryCatch tryCatch;
+			Handle<Value> trimmed = Handle<Function>::Cast(trimCache)->Call(moduleObject, 0, NULL);
+			if (tryCatch.HasCaught()) {
+				V8Util::reportException(tryCatch);
+			} else {
+				LOGD(TAG, "Trimmed %d disposable modules from the module cache", trimmed->Int32Value());
+			}
+		}
+	}
+
+	V8::LowMemoryNotification();
+	LOG_HEAP_STATS(TAG);
+}
+
+JNIEXPORT jboolean JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Runtime_nativeTakeHeapSnapshot(JNIEnv *env, jobject self, jstring path)
+{
+	ENTER_V8(V8Runtime::globalContext);
+
+	const char *nativePath = env->GetStringUTFChars(path, NULL);
+	bool written = Profiler::takeHeapSnapshot(nativePath);
+	env->ReleaseStringUTFChars(path, nativePath);
+
+	return written;
+}
+
+JNIEXPORT jlong JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Runtime_nativeStartAllocationTracking(JNIEnv *env, jobject self, jstring path)
+{
+	ENTER_V8(V8Runtime::globalContext);
+
+	const char *nativePath = env->GetStringUTFChars(path, NULL);
+	bool started = Profiler::startAllocationTracking(nativePath);
+	env->ReleaseStringUTFChars(path, nativePath);
+
+	return started ? (jlong) Profiler::getTrackingStartId() : -1;
+}
+
+JNIEXPORT jboolean JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Runtime_nativeStopAllocationTracking(JNIEnv *env, jobject self, jstring path)
+{
+	ENTER_V8(V8Runtime::globalContext);
+
+	const char *nativePath = env->GetStringUTFChars(path, NULL);
+	bool written = Profiler::stopAllocationTracking(nativePath);
+	env->ReleaseStringUTFChars(path, nativePath);
+
+	return written;
+}
+
+JNIEXPORT jboolean JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Runtime_nativeStartCpuProfiling(JNIEnv *env, jobject self, jstring label)
+{
+	ENTER_V8(V8Runtime::globalContext);
+
+	const char *nativeLabel = env->GetStringUTFChars(label, NULL);
+	bool started = Profiler::startCpuProfiling(nativeLabel);
+	env->ReleaseStringUTFChars(label, nativeLabel);
+
+	return started;
+}
+
+JNIEXPORT jboolean JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Runtime_nativeStopCpuProfiling(JNIEnv *env, jobject self, jstring label, jstring path)
+{
+	ENTER_V8(V8Runtime::globalContext);
+
+	const char *nativeLabel = env->GetStringUTFChars(label, NULL);
+	const char *nativePath = env->GetStringUTFChars(path, NULL);
+	bool written = Profiler::stopCpuProfiling(nativeLabel, nativePath);
+	env->ReleaseStringUTFChars(path, nativePath);
+	env->ReleaseStringUTFChars(label, nativeLabel);
+
+	return written;
+}
+
+JNIEXPORT jboolean JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Runtime_nativePostEvent(JNIEnv *env, jclass clazz, jobject proxy, jstring event, jobject data, jint coalescing)
+{
+	return EventQueue::post(env, proxy, event, data, coalescing);
+}
+
+JNIEXPORT jint JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Runtime_nativeDrainEvents(JNIEnv *env, jobject self)
+{
+	titanium::JNIScope jniScope(env);
+	return EventQueue::drain(env);
+}
+
+JNIEXPORT jint JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Runtime_nativeDrainCalls(JNIEnv *env, jclass clazz, jboolean blocking)
+{
+	titanium::JNIScope jniScope(env);
+	return CallQueue::drain(env, blocking);
+}
+
+JNIEXPORT jint JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Runtime_nativeDrainAsyncMethods(JNIEnv *env, jclass clazz)
+{
+	titanium::JNIScope jniScope(env);
+	return AsyncMethod::drain(env);
+}
+
+JNIEXPORT void JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Runtime_nativeDumpProxyCensus(JNIEnv *env, jclass clazz)
+{
+	ProxyCensus::dump();
 }
 
 /*
@@ -343,6 +500,9 @@ JNIEXPORT void JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Runtime_nativeDi
 
 	V8Util::dispose();
 	ProxyFactory::dispose();
+	Profiler::dispose();
+	AsyncMethod::dispose(env);
+	JSException::dispose(env);
 
 	moduleObject.Dispose();
 	moduleObject = Persistent<Object>();
@@ -364,7 +524,16 @@ JNIEXPORT void JNICALL Java_org_appcelerator_kroll_runtime_v8_V8Runtime_nativeDi
 	// idle event in V8Runtime.java), we can't count on that running anymore at this point.
 	// So as our last act, run IdleNotification until it returns true so we can clean up all
 	// the stuff we just released references for above.
-	while (!v8::V8::IdleNotification());
+	IdleScheduler::collectAll();
+	IdleScheduler::logStats();
+	IdleScheduler::reset();
+
+	EventQueue::dispose(env);
+	CallQueue::dispose(env);
+
+	WrapperPool::dispose();
+
+	JavaObject::disposeGCCallbacks();
 }
 
 jint JNI_OnLoad(JavaVM *vm, void *reserved)
@@ -122,6 +122,8 @@ void V8Util::reportException(TryCatch &tryCatch, bool showLine)
 			LOGE(EXC_TAG, *error);
 		}
 	}
+
+	JSException::logJavaStack(tryCatch.Exception());
 }
 
 void V8Util::openJSErrorDialog(TryCatch &tryCatch)
@@ -0,0 +1,248 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#include <malloc.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "AndroidUtil.h"
+#include "WrapperPool.h"
+
+#define TAG "WrapperPool"
+
+namespace titanium {
+
+struct Pool;
+
+struct FreeSlot
+{
+	FreeSlot *next;
+};
+
+// Slabs are aligned on their size, so the slab of a slot
+// is found by masking the slot's address.
+struct Slab
+{
+	Pool *pool;
+	Slab *next;
+	uint32_t live;
+};
+
+struct SizeClass
+{
+	FreeSlot *freeList;
+	WrapperPool::Stats stats;
+};
+
+struct Pool
+{
+	SizeClass sizeClasses[WrapperPool::kSizeClassCount];
+	Slab *slabs;
+	uint32_t oversizeAllocations;
+	uint32_t retainedSlabs; // slabs of live wrappers, once disposed
+	bool disposed;
+};
+
+static Pool *currentPool = NULL;
+static uint32_t retainedWrappers = 0;
+static uint32_t retainedSlabs = 0;
+
+// The slab header is padded so slots keep their alignment.
+static const size_t slabHeaderSize =
+	(sizeof(Slab) + WrapperPool::kSlotAlignment - 1) & ~(WrapperPool::kSlotAlignment - 1);
+
+static inline int sizeClassIndex(size_t size)
+{
+	return (size + WrapperPool::kSlotAlignment - 1) / WrapperPool::kSlotAlignment - 1;
+}
+
+static inline Slab* slabOf(void *slot)
+{
+	return reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(slot) & ~(uintptr_t) (WrapperPool::kSlabSize - 1));
+}
+
+static void outOfMemory(size_t size)
+{
+	// The runtime is built without exceptions.
+	LOGE(TAG, "Out of memory allocating a %u byte wrapper", (unsigned int) size);
+	abort();
+}
+
+static bool growSizeClass(Pool *pool, SizeClass &sizeClass, size_t slotSize)
+{
+	Slab *slab = static_cast<Slab*>(memalign(WrapperPool::kSlabSize, WrapperPool::kSlabSize));
+	if (!slab) {
+		return false;
+	}
+
+	slab->pool = pool;
+	slab->live = 0;
+	slab->next = pool->slabs;
+	pool->slabs = slab;
+	sizeClass.stats.slabs++;
+
+	char *slot = reinterpret_cast<char*>(slab) + slabHeaderSize;
+	char *end = reinterpret_cast<char*>(slab) + WrapperPool::kSlabSize;
+	for (; slot + slotSize <= end; slot += slotSize) {
+		FreeSlot *freeSlot = reinterpret_cast<FreeSlot*>(slot);
+		freeSlot->next = sizeClass.freeList;
+		sizeClass.freeList = freeSlot;
+	}
+
+	return true;
+}
+
+void* WrapperPool::allocate(size_t size)
+{
+	Pool *pool = currentPool;
+	if (!pool) {
+		pool = currentPool = static_cast<Pool*>(calloc(1, sizeof(Pool)));
+		if (!pool) {
+			outOfMemory(size);
+		}
+	}
+
+	int index = sizeClassIndex(size);
+	if (index >= kSizeClassCount) {
+		pool->oversizeAllocations++;
+		return ::operator new(size);
+	}
+
+	SizeClass &sizeClass = pool->sizeClasses[index];
+	size_t slotSize = (index + 1) * kSlotAlignment;
+	if (!sizeClass.freeList && !growSizeClass(pool, sizeClass, slotSize)) {
+		outOfMemory(size);
+	}
+
+	FreeSlot *slot = sizeClass.freeList;
+	sizeClass.freeList = slot->next;
+	slabOf(slot)->live++;
+
+	Stats &stats = sizeClass.stats;
+	stats.slotSize = slotSize;
+	stats.allocations++;
+	if (++stats.live > stats.peak) {
+		stats.peak = stats.live;
+	}
+
+	return slot;
+}
+
+void WrapperPool::release(void *ptr, size_t size)
+{
+	if (!ptr) {
+		return;
+	}
+
+	int index = sizeClassIndex(size);
+	if (index >= kSizeClassCount) {
+		::operator delete(ptr);
+		return;
+	}
+
+	Slab *slab = slabOf(ptr);
+	Pool *pool = slab->pool;
+	slab->live--;
+
+	if (pool->disposed) {
+		// A wrapper which outlived its runtime, its slab
+		// goes away with the last of them.
+		retainedWrappers--;
+		if (slab->live == 0) {
+			free(slab);
+			retainedSlabs--;
+			if (--pool->retainedSlabs == 0) {
+				free(pool);
+			}
+		}
+		return;
+	}
+
+	SizeClass &sizeClass = pool->sizeClasses[index];
+	FreeSlot *slot = static_cast<FreeSlot*>(ptr);
+	slot->next = sizeClass.freeList;
+	sizeClass.freeList = slot;
+	sizeClass.stats.live--;
+}
+
+void WrapperPool::getStats(int sizeClass, Stats *stats)
+{
+	if (currentPool) {
+		*stats = currentPool->sizeClasses[sizeClass].stats;
+	} else {
+		memset(stats, 0, sizeof(Stats));
+	}
+}
+
+uint32_t WrapperPool::getOversizeAllocations()
+{
+	return currentPool ? currentPool->oversizeAllocations : 0;
+}
+
+uint32_t WrapperPool::getRetainedWrappers()
+{
+	return retainedWrappers;
+}
+
+uint32_t WrapperPool::getRetainedSlabs()
+{
+	return retainedSlabs;
+}
+
+void WrapperPool::logStats()
+{
+	for (int i = 0; i < kSizeClassCount; ++i) {
+		Stats stats;
+		getStats(i, &stats);
+		if (stats.allocations == 0) {
+			continue;
+		}
+		LOGD(TAG, "%u byte slots: slabs=%u live=%u peak=%u allocations=%u",
+			stats.slotSize, stats.slabs, stats.live, stats.peak, stats.allocations);
+	}
+	if (getOversizeAllocations() > 0) {
+		LOGD(TAG, "Oversize allocations: %u", getOversizeAllocations());
+	}
+}
+
+void WrapperPool::dispose()
+{
+	Pool *pool = currentPool;
+	if (!pool) {
+		return;
+	}
+
+	logStats();
+
+	uint32_t leaked = 0;
+	Slab *slab = pool->slabs;
+	while (slab) {
+		Slab *next = slab->next;
+		if (slab->live == 0) {
+			free(slab);
+		} else {
+			leaked += slab->live;
+			pool->retainedSlabs++;
+		}
+		slab = next;
+	}
+
+	pool->slabs = NULL;
+	pool->disposed = true;
+	currentPool = NULL;
+
+	if (pool->retainedSlabs == 0) {
+		free(pool);
+		return;
+	}
+
+	retainedWrappers += leaked;
+	retainedSlabs += pool->retainedSlabs;
+	LOGW(TAG, "%u native wrappers are still alive after dispose, %u slabs are kept until they are deleted",
+		leaked, pool->retainedSlabs);
+}
+
+} // namespace titanium
@@ -0,0 +1,71 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#ifndef TI_KROLL_WRAPPER_POOL_H
+#define TI_KROLL_WRAPPER_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace titanium {
+
+// Slab allocator for the native wrappers of JavaScript objects
+// (see NativeObject). Wrappers are grouped in size classes, each
+// class carves fixed-size slots out of slabs and recycles freed
+// slots through a free list. Larger objects use the regular heap.
+//
+// Each runtime allocates from its own pool, created on first use.
+// dispose() frees every slab of the pool without live wrappers. A
+// wrapper still alive then (held by a Java object which outlives the
+// runtime, or waiting for a weak callback) keeps its slab, which is
+// freed with the last such wrapper. Only wrappers which are never
+// deleted leak, along with their slab. The next runtime starts from a
+// new pool and never reuses the slots of a disposed one.
+//
+// Wrappers are only created and deleted on the KrollRuntime thread,
+// the pool does no locking.
+class WrapperPool
+{
+public:
+	enum {
+		kSlotAlignment = 16,
+		kSizeClassCount = 16, // slots up to 256 bytes
+		kSlabSize = 4096
+	};
+
+	struct Stats
+	{
+		uint32_t slotSize;
+		uint32_t slabs;
+		uint32_t live;
+		uint32_t peak;
+		uint32_t allocations;
+	};
+
+	static void* allocate(size_t size);
+	static void release(void *ptr, size_t size);
+
+	// Statistics of a size class of the current runtime,
+	// index 0 to kSizeClassCount - 1.
+	static void getStats(int sizeClass, Stats *stats);
+
+	// Number of allocations too large for the pools.
+	static uint32_t getOversizeAllocations();
+
+	// Wrappers of disposed runtimes not deleted yet, and their slabs.
+	static uint32_t getRetainedWrappers();
+	static uint32_t getRetainedSlabs();
+
+	static void logStats();
+
+	// Frees the pool of the current runtime, except the slabs
+	// of live wrappers. Called when the runtime is disposed.
+	static void dispose();
+};
+
+} // namespace titanium
+
+#endif
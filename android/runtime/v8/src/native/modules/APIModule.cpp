@@ -15,9 +15,16 @@
 #include "AndroidUtil.h"
 
 #include "APIModule.h"
+#include "EventQueue.h"
+#include "IdleScheduler.h"
+#include "JavaObject.h"
 #include "JNIUtil.h"
+#include "Profiler.h"
+#include "ProxyCensus.h"
+#include "ProxyFactory.h"
 #include "V8Runtime.h"
 #include "V8Util.h"
+#include "WrapperPool.h"
 #include "org.appcelerator.kroll.KrollModule.h"
 
 namespace titanium {
@@ -52,6 +59,12 @@ void APIModule::Initialize(Handle<Object> target)
 	DEFINE_PROTOTYPE_METHOD(constructorTemplate, "fatal", logFatal);
 	DEFINE_PROTOTYPE_METHOD(constructorTemplate, "log", log);
 	DEFINE_PROTOTYPE_METHOD(constructorTemplate, "getApiName", APIModule::getApiName);
+	DEFINE_PROTOTYPE_METHOD(constructorTemplate, "getProxyCensus", ProxyCensus::getProxyCensus);
+	DEFINE_PROTOTYPE_METHOD(constructorTemplate, "getEventQueueStats", EventQueue::getEventQueueStats);
+	DEFINE_PROTOTYPE_METHOD(constructorTemplate, "getGCStats", JavaObject::getGCStats);
+	DEFINE_PROTOTYPE_METHOD(constructorTemplate, "getWrapperPoolStats", APIModule::getWrapperPoolStats);
+	DEFINE_PROTOTYPE_METHOD(constructorTemplate, "getProxyFactoryStats", APIModule::getProxyFactoryStats);
+	DEFINE_PROTOTYPE_METHOD(constructorTemplate, "getIdleStats", APIModule::getIdleStats);
 
 	Local<ObjectTemplate> instanceTemplate = constructorTemplate->InstanceTemplate();
 	instanceTemplate->SetAccessor(String::NewSymbol("apiName"), APIModule::getter_apiName);
@@ -64,6 +77,14 @@ void APIModule::Initialize(Handle<Object> target)
 		DEFINE_PROTOTYPE_METHOD(constructorTemplate, "debugBreak", debugBreak);
 	}
 
+	if (Profiler::enabled) {
+		DEFINE_PROTOTYPE_METHOD(constructorTemplate, "takeHeapSnapshot", Profiler::takeHeapSnapshot);
+		DEFINE_PROTOTYPE_METHOD(constructorTemplate, "startAllocationTracking", Profiler::startAllocationTracking);
+		DEFINE_PROTOTYPE_METHOD(constructorTemplate, "stopAllocationTracking", Profiler::stopAllocationTracking);
+		DEFINE_PROTOTYPE_METHOD(constructorTemplate, "startProfiling", Profiler::startProfiling);
+		DEFINE_PROTOTYPE_METHOD(constructorTemplate, "stopProfiling", Profiler::stopProfiling);
+	}
+
 	constructorTemplate->Inherit(KrollModule::proxyTemplate);
 
 	target->Set(String::NewSymbol("API"), constructorTemplate->GetFunction()->NewInstance());
@@ -259,6 +280,69 @@ Handle<Value> APIModule::debugBreak(const Arguments& args)
 	return Undefined();
 }
 
+Handle<Value> APIModule::getWrapperPoolStats(const Arguments& args)
+{
+	HandleScope scope;
+
+	Local<Array> sizeClasses = Array::New();
+	for (int i = 0, index = 0; i < WrapperPool::kSizeClassCount; ++i) {
+		WrapperPool::Stats stats;
+		WrapperPool::getStats(i, &stats);
+		if (stats.allocations == 0) {
+			continue;
+		}
+
+		Local<Object> sizeClass = Object::New();
+		sizeClass->Set(String::NewSymbol("slotSize"), Integer::NewFromUnsigned(stats.slotSize));
+		sizeClass->Set(String::NewSymbol("slabs"), Integer::NewFromUnsigned(stats.slabs));
+		sizeClass->Set(String::NewSymbol("live"), Integer::NewFromUnsigned(stats.live));
+		sizeClass->Set(String::NewSymbol("peak"), Integer::NewFromUnsigned(stats.peak));
+		sizeClass->Set(String::NewSymbol("allocations"), Integer::NewFromUnsigned(stats.allocations));
+		sizeClasses->Set(index++, sizeClass);
+	}
+
+	Local<Object> result = Object::New();
+	result->Set(String::NewSymbol("sizeClasses"), sizeClasses);
+	result->Set(String::NewSymbol("oversizeAllocations"), Integer::NewFromUnsigned(WrapperPool::getOversizeAllocations()));
+	result->Set(String::NewSymbol("retainedWrappers"), Integer::NewFromUnsigned(WrapperPool::getRetainedWrappers()));
+	result->Set(String::NewSymbol("retainedSlabs"), Integer::NewFromUnsigned(WrapperPool::getRetainedSlabs()));
+
+	return scope.Close(result);
+}
+
+Handle<Value> APIModule::getProxyFactoryStats(const Arguments& args)
+{
+	HandleScope scope;
+
+	ProxyFactory::Stats stats;
+	ProxyFactory::getStats(&stats);
+
+	Local<Object> result = Object::New();
+	result->Set(String::NewSymbol("entries"), Integer::NewFromUnsigned(stats.entries));
+	result->Set(String::NewSymbol("lookups"), Integer::NewFromUnsigned(stats.lookups));
+	result->Set(String::NewSymbol("hits"), Integer::NewFromUnsigned(stats.hits));
+	result->Set(String::NewSymbol("misses"), Integer::NewFromUnsigned(stats.misses));
+
+	return scope.Close(result);
+}
+
+Handle<Value> APIModule::getIdleStats(const Arguments& args)
+{
+	HandleScope scope;
+
+	IdleScheduler::Stats stats;
+	IdleScheduler::getStats(&stats);
+
+	Local<Object> result = Object::New();
+	result->Set(String::NewSymbol("calls"), Integer::NewFromUnsigned(stats.calls));
+	result->Set(String::NewSymbol("skipped"), Integer::NewFromUnsigned(stats.skipped));
+	result->Set(String::NewSymbol("completed"), Integer::NewFromUnsigned(stats.completed));
+	result->Set(String::NewSymbol("time"), Number::New(stats.timeUs / 1000.0));
+	result->Set(String::NewSymbol("bytesFreed"), Number::New((double) stats.bytesFreed));
+
+	return scope.Close(result);
+}
+
 void APIModule::Dispose()
 {
 	constructorTemplate.Dispose();
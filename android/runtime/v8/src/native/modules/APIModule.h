@@ -29,6 +29,15 @@ public:
 	static Handle<Value> logFatal(const Arguments& args);
 	static Handle<Value> log(const Arguments& args);
 
+	// Counters of the slab pools of the native wrappers.
+	static Handle<Value> getWrapperPoolStats(const Arguments& args);
+
+	// Counters of the proxy class registry lookups.
+	static Handle<Value> getProxyFactoryStats(const Arguments& args);
+
+	// Counters of the idle-time GC work.
+	static Handle<Value> getIdleStats(const Arguments& args);
+
 	// Only used by debugger for terminating application.
 	static Handle<Value> terminate(const Arguments& args);
 
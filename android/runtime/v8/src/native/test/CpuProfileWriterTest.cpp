@@ -0,0 +1,99 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#include <string>
+
+#include "CpuProfileWriter.h"
+#include "TestUtil.h"
+
+using namespace titanium;
+
+static std::string readAll(FILE *file)
+{
+	std::string content;
+	rewind(file);
+	int c;
+	while ((c = fgetc(file)) != EOF) {
+		content += (char) c;
+	}
+	fclose(file);
+	return content;
+}
+
+static void testCallTree()
+{
+	FILE *file = tmpfile();
+	CHECK(file != NULL);
+
+	CpuProfileWriter writer(file);
+	writer.begin(1.5, 2.25);
+	writer.beginNode("(root)", "", 0, 0, 1);
+	writer.beginNode("main", "app.js", 3, 10, 2);
+	writer.beginNode("draw", "ui.js", 42, 5, 3);
+	writer.endNode();
+	writer.endNode();
+	writer.beginNode("(idle)", "", 0, 7, 4);
+	writer.endNode();
+	writer.endNode();
+	CHECK(writer.end());
+
+	std::string expected =
+		"{\"head\":"
+		"{\"functionName\":\"(root)\",\"scriptId\":\"0\",\"url\":\"\",\"lineNumber\":0,\"columnNumber\":0,"
+			"\"hitCount\":0,\"callUID\":1,\"id\":1,\"children\":["
+		"{\"functionName\":\"main\",\"scriptId\":\"0\",\"url\":\"app.js\",\"lineNumber\":3,\"columnNumber\":0,"
+			"\"hitCount\":10,\"callUID\":2,\"id\":2,\"children\":["
+		"{\"functionName\":\"draw\",\"scriptId\":\"0\",\"url\":\"ui.js\",\"lineNumber\":42,\"columnNumber\":0,"
+			"\"hitCount\":5,\"callUID\":3,\"id\":3,\"children\":[]}"
+		"]},"
+		"{\"functionName\":\"(idle)\",\"scriptId\":\"0\",\"url\":\"\",\"lineNumber\":0,\"columnNumber\":0,"
+			"\"hitCount\":7,\"callUID\":4,\"id\":4,\"children\":[]}"
+		"]}"
+		",\"startTime\":1.500000,\"endTime\":2.250000,\"samples\":[]}";
+
+	std::string written = readAll(file);
+	if (written != expected) {
+		fprintf(stderr, "written:  %s\nexpected: %s\n", written.c_str(), expected.c_str());
+	}
+	CHECK(written == expected);
+}
+
+static void testStringEscapes()
+{
+	FILE *file = tmpfile();
+	CHECK(file != NULL);
+
+	CpuProfileWriter writer(file);
+	writer.begin(0, 0);
+	writer.beginNode("a\"b\\c\n\t\x01\xc3\xa9", NULL, 1, 0, 0);
+	writer.endNode();
+	CHECK(writer.end());
+
+	std::string written = readAll(file);
+	CHECK(written.find("\"functionName\":\"a\\\"b\\\\c\\n\\t\\u0001\xc3\xa9\"") != std::string::npos);
+	// a NULL string is written as an empty one
+	CHECK(written.find("\"url\":\"\"") != std::string::npos);
+}
+
+static void testUnbalancedNodes()
+{
+	FILE *file = tmpfile();
+	CHECK(file != NULL);
+
+	CpuProfileWriter writer(file);
+	writer.begin(0, 0);
+	writer.beginNode("(root)", "", 0, 0, 0);
+	CHECK(!writer.end());
+	fclose(file);
+}
+
+int main()
+{
+	RUN_TEST(testCallTree);
+	RUN_TEST(testStringEscapes);
+	RUN_TEST(testUnbalancedNodes);
+	return 0;
+}
@@ -0,0 +1,180 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#include <vector>
+
+#include "EventCoalescer.h"
+#include "TestUtil.h"
+
+using namespace titanium;
+
+struct FakeEvent
+{
+	FakeEvent *next;
+	int coalescing;
+	int proxy;
+	char type;
+	int data;
+	std::vector<int> history; // newest first, as EventQueue keeps it
+	bool finished;
+};
+
+class FakePolicy
+{
+public:
+	FakePolicy()
+		: released(0)
+	{
+	}
+
+	bool sameTarget(FakeEvent *a, FakeEvent *b)
+	{
+		return a->proxy == b->proxy && a->type == b->type;
+	}
+
+	void accumulate(FakeEvent *kept, FakeEvent *earlier)
+	{
+		kept->history.push_back(earlier->data);
+	}
+
+	void supersede(FakeEvent *pending, FakeEvent *incoming)
+	{
+		if (pending->coalescing == EventCoalescer::ACCUMULATE) {
+			pending->history.insert(pending->history.begin(), pending->data);
+		}
+		pending->data = incoming->data;
+	}
+
+	void finish(FakeEvent *kept)
+	{
+		kept->finished = true;
+	}
+
+	void release(FakeEvent *)
+	{
+		released++;
+	}
+
+	int released;
+};
+
+static FakeEvent* event(int coalescing, int proxy, char type, int data)
+{
+	FakeEvent *e = new FakeEvent();
+	e->next = NULL;
+	e->coalescing = coalescing;
+	e->proxy = proxy;
+	e->type = type;
+	e->data = data;
+	e->finished = false;
+	return e;
+}
+
+static void testNoneIsNeverCoalesced()
+{
+	std::vector<FakeEvent*> batch;
+	batch.push_back(event(EventCoalescer::NONE, 1, 'c', 1));
+	batch.push_back(event(EventCoalescer::NONE, 1, 'c', 2));
+
+	FakePolicy policy;
+	CHECK(EventCoalescer::coalesce(batch, policy) == 0);
+	CHECK(batch[0] && batch[1]);
+	CHECK(policy.released == 0);
+}
+
+static void testLatestKeepsNewest()
+{
+	std::vector<FakeEvent*> batch;
+	batch.push_back(event(EventCoalescer::LATEST, 1, 's', 1));
+	batch.push_back(event(EventCoalescer::NONE, 1, 'c', 2));
+	batch.push_back(event(EventCoalescer::LATEST, 1, 's', 3));
+	batch.push_back(event(EventCoalescer::LATEST, 2, 's', 4));
+	batch.push_back(event(EventCoalescer::LATEST, 1, 's', 5));
+
+	FakePolicy policy;
+	CHECK(EventCoalescer::coalesce(batch, policy) == 2);
+	CHECK(policy.released == 2);
+
+	CHECK(batch[0] == NULL);
+	CHECK(batch[1] && batch[1]->data == 2);
+	CHECK(batch[2] == NULL);
+	CHECK(batch[3] && batch[3]->data == 4);
+	CHECK(batch[4] && batch[4]->data == 5);
+	CHECK(batch[4]->history.empty());
+}
+
+static void testAccumulateCollectsHistory()
+{
+	std::vector<FakeEvent*> batch;
+	batch.push_back(event(EventCoalescer::ACCUMULATE, 1, 'm', 1));
+	batch.push_back(event(EventCoalescer::ACCUMULATE, 1, 'm', 2));
+	batch.push_back(event(EventCoalescer::ACCUMULATE, 1, 'm', 3));
+
+	FakePolicy policy;
+	CHECK(EventCoalescer::coalesce(batch, policy) == 2);
+
+	FakeEvent *kept = batch[2];
+	CHECK(batch[0] == NULL && batch[1] == NULL);
+	CHECK(kept->data == 3);
+	CHECK(kept->history.size() == 2);
+	CHECK(kept->history[0] == 2 && kept->history[1] == 1);
+	CHECK(kept->finished);
+}
+
+static void testSupersedeReplacesPending()
+{
+	// the list is linked newest first, as producers push on its head
+	FakeEvent *older = event(EventCoalescer::LATEST, 1, 's', 1);
+	FakeEvent *click = event(EventCoalescer::NONE, 1, 's', 2);
+	FakeEvent *newer = event(EventCoalescer::LATEST, 1, 's', 3);
+	newer->next = click;
+	click->next = older;
+
+	FakePolicy policy;
+	FakeEvent *incoming = event(EventCoalescer::LATEST, 1, 's', 4);
+	CHECK(EventCoalescer::supersede(newer, incoming, policy));
+	CHECK(newer->data == 4);
+	CHECK(click->data == 2);
+	CHECK(older->data == 1);
+
+	FakeEvent *otherProxy = event(EventCoalescer::LATEST, 2, 's', 5);
+	CHECK(!EventCoalescer::supersede(newer, otherProxy, policy));
+
+	FakeEvent *notCoalescable = event(EventCoalescer::NONE, 1, 's', 6);
+	CHECK(!EventCoalescer::supersede(newer, notCoalescable, policy));
+	CHECK(newer->data == 4);
+}
+
+static void testSupersedeThenCoalesceKeepsHistoryOrder()
+{
+	FakeEvent *first = event(EventCoalescer::ACCUMULATE, 1, 'm', 1);
+	FakeEvent *second = event(EventCoalescer::ACCUMULATE, 1, 'm', 2);
+	second->next = first;
+
+	FakePolicy policy;
+	FakeEvent *incoming = event(EventCoalescer::ACCUMULATE, 1, 'm', 3);
+	CHECK(EventCoalescer::supersede(second, incoming, policy));
+
+	std::vector<FakeEvent*> batch;
+	batch.push_back(first);
+	batch.push_back(second);
+	CHECK(EventCoalescer::coalesce(batch, policy) == 1);
+
+	CHECK(second->data == 3);
+	CHECK(second->history.size() == 2);
+	CHECK(second->history[0] == 2 && second->history[1] == 1);
+	CHECK(second->finished);
+}
+
+int main()
+{
+	RUN_TEST(testNoneIsNeverCoalesced);
+	RUN_TEST(testLatestKeepsNewest);
+	RUN_TEST(testAccumulateCollectsHistory);
+	RUN_TEST(testSupersedeReplacesPending);
+	RUN_TEST(testSupersedeThenCoalesceKeepsHistoryOrder);
+	return 0;
+}
@@ -0,0 +1,167 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#include <pthread.h>
+#include <string.h>
+
+#include "RingBuffer.h"
+#include "TestUtil.h"
+
+using namespace titanium;
+
+#define PRODUCERS 4
+#define ITEMS_PER_PRODUCER 100000
+
+typedef RingBuffer<uint32_t, 8> SmallRing;
+typedef RingBuffer<uint32_t, 256> CallRing;
+
+static void testFifo()
+{
+	SmallRing ring;
+	uint32_t item;
+
+	CHECK(!ring.pop(&item));
+	for (uint32_t i = 0; i < 5; i++) {
+		CHECK(ring.push(i));
+	}
+	for (uint32_t i = 0; i < 5; i++) {
+		CHECK(ring.pop(&item));
+		CHECK(item == i);
+	}
+	CHECK(!ring.pop(&item));
+}
+
+static void testFull()
+{
+	SmallRing ring;
+	uint32_t item;
+
+	for (uint32_t i = 0; i < 8; i++) {
+		CHECK(ring.push(i));
+	}
+	CHECK(!ring.push(8));
+
+	CHECK(ring.pop(&item));
+	CHECK(item == 0);
+	CHECK(ring.push(8));
+	CHECK(!ring.push(9));
+
+	for (uint32_t i = 1; i <= 8; i++) {
+		CHECK(ring.pop(&item));
+		CHECK(item == i);
+	}
+}
+
+static void testWrapAround()
+{
+	SmallRing ring;
+	uint32_t item;
+
+	for (uint32_t i = 0; i < 1000; i++) {
+		CHECK(ring.push(i));
+		CHECK(ring.push(i + 1));
+		CHECK(ring.pop(&item));
+		CHECK(item == i);
+		CHECK(ring.pop(&item));
+		CHECK(item == i + 1);
+	}
+}
+
+static void testBatchMark()
+{
+	SmallRing ring;
+	uint32_t item;
+
+	ring.push(1);
+	ring.push(2);
+	uint32_t mark = ring.pushed();
+	ring.push(3);
+
+	CHECK(ring.pop(&item, mark));
+	CHECK(item == 1);
+	CHECK(ring.pop(&item, mark));
+	CHECK(item == 2);
+
+	// pushed after the mark, left for the next batch
+	CHECK(!ring.pop(&item, mark));
+	CHECK(ring.pop(&item, ring.pushed()));
+	CHECK(item == 3);
+}
+
+static void testReset()
+{
+	SmallRing ring;
+	uint32_t item;
+
+	ring.push(1);
+	ring.push(2);
+	ring.reset();
+	CHECK(!ring.pop(&item));
+	CHECK(ring.pushed() == 0);
+
+	for (uint32_t i = 0; i < 8; i++) {
+		CHECK(ring.push(i));
+	}
+}
+
+static CallRing sharedRing;
+
+static void* produce(void *arg)
+{
+	uint32_t producer = (uint32_t) (uintptr_t) arg;
+	for (uint32_t i = 0; i < ITEMS_PER_PRODUCER; i++) {
+		uint32_t item = (producer << 24) | i;
+		while (!sharedRing.push(item)) {
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+// Every item arrives once, and the items of one producer in order.
+static void testConcurrentProducers()
+{
+	pthread_t threads[PRODUCERS];
+	uint32_t next[PRODUCERS];
+	memset(next, 0, sizeof(next));
+
+	for (uintptr_t i = 0; i < PRODUCERS; i++) {
+		CHECK(pthread_create(&threads[i], NULL, produce, (void*) i) == 0);
+	}
+
+	uint32_t received = 0;
+	while (received < PRODUCERS * ITEMS_PER_PRODUCER) {
+		uint32_t item;
+		if (!sharedRing.pop(&item)) {
+			sched_yield();
+			continue;
+		}
+		uint32_t producer = item >> 24;
+		CHECK(producer < PRODUCERS);
+		CHECK((item & 0xffffff) == next[producer]);
+		next[producer]++;
+		received++;
+	}
+
+	for (int i = 0; i < PRODUCERS; i++) {
+		pthread_join(threads[i], NULL);
+		CHECK(next[i] == ITEMS_PER_PRODUCER);
+	}
+
+	uint32_t item;
+	CHECK(!sharedRing.pop(&item));
+}
+
+int main()
+{
+	RUN_TEST(testFifo);
+	RUN_TEST(testFull);
+	RUN_TEST(testWrapAround);
+	RUN_TEST(testBatchMark);
+	RUN_TEST(testReset);
+	RUN_TEST(testConcurrentProducers);
+	return 0;
+}
@@ -0,0 +1,30 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Host tests of the runtime components which do not depend on JNI or V8.
+// Each test is a program which exits with a non zero status on failure.
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			exit(1); \
+		} \
+	} while (0)
+
+#define RUN_TEST(test) \
+	do { \
+		test(); \
+		printf("ok - %s\n", #test); \
+	} while (0)
+
+#endif
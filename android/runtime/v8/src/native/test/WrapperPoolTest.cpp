@@ -0,0 +1,123 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+#include "TestUtil.h"
+#include "WrapperPool.h"
+
+using namespace titanium;
+
+static uint32_t live(size_t size)
+{
+	WrapperPool::Stats stats;
+	WrapperPool::getStats((size - 1) / WrapperPool::kSlotAlignment, &stats);
+	return stats.live;
+}
+
+static void testReuse()
+{
+	void *first = WrapperPool::allocate(40);
+	CHECK(first != NULL);
+	CHECK(((uintptr_t) first % WrapperPool::kSlotAlignment) == 0);
+	CHECK(live(40) == 1);
+
+	WrapperPool::release(first, 40);
+	CHECK(live(40) == 0);
+
+	// freed slots are recycled before carving new ones
+	void *second = WrapperPool::allocate(40);
+	CHECK(second == first);
+	WrapperPool::release(second, 40);
+
+	WrapperPool::dispose();
+}
+
+static void testStats()
+{
+	std::vector<void*> slots;
+	for (int i = 0; i < 1000; i++) {
+		void *slot = WrapperPool::allocate(64);
+		CHECK(slot != NULL);
+		memset(slot, 0xab, 64);
+		slots.push_back(slot);
+	}
+
+	WrapperPool::Stats stats;
+	WrapperPool::getStats(3, &stats);
+	CHECK(stats.slotSize == 64);
+	CHECK(stats.live == 1000);
+	CHECK(stats.peak == 1000);
+	CHECK(stats.allocations == 1000);
+	CHECK(stats.slabs > 1);
+
+	for (size_t i = 0; i < slots.size(); i++) {
+		WrapperPool::release(slots[i], 64);
+	}
+
+	WrapperPool::getStats(3, &stats);
+	CHECK(stats.live == 0);
+	CHECK(stats.peak == 1000);
+
+	WrapperPool::dispose();
+	WrapperPool::getStats(3, &stats);
+	CHECK(stats.allocations == 0);
+	CHECK(WrapperPool::getRetainedWrappers() == 0);
+	CHECK(WrapperPool::getRetainedSlabs() == 0);
+}
+
+static void testOversize()
+{
+	size_t size = WrapperPool::kSizeClassCount * WrapperPool::kSlotAlignment + 1;
+	void *ptr = WrapperPool::allocate(size);
+	CHECK(ptr != NULL);
+	CHECK(WrapperPool::getOversizeAllocations() == 1);
+	WrapperPool::release(ptr, size);
+
+	WrapperPool::dispose();
+	CHECK(WrapperPool::getOversizeAllocations() == 0);
+}
+
+static void testWrappersOutliveDispose()
+{
+	void *kept = WrapperPool::allocate(32);
+	void *other = WrapperPool::allocate(128);
+	void *freed = WrapperPool::allocate(32);
+	WrapperPool::release(freed, 32);
+
+	WrapperPool::dispose();
+	CHECK(WrapperPool::getRetainedWrappers() == 2);
+	CHECK(WrapperPool::getRetainedSlabs() == 2);
+
+	// the next runtime never hands out a slot of the disposed pool
+	void *next = WrapperPool::allocate(32);
+	CHECK(next != freed);
+	CHECK(live(32) == 1);
+
+	WrapperPool::release(kept, 32);
+	CHECK(WrapperPool::getRetainedWrappers() == 1);
+	CHECK(WrapperPool::getRetainedSlabs() == 1);
+	CHECK(live(32) == 1);
+
+	WrapperPool::release(other, 128);
+	CHECK(WrapperPool::getRetainedWrappers() == 0);
+	CHECK(WrapperPool::getRetainedSlabs() == 0);
+
+	WrapperPool::release(next, 32);
+	WrapperPool::dispose();
+	CHECK(WrapperPool::getRetainedWrappers() == 0);
+}
+
+int main()
+{
+	RUN_TEST(testReuse);
+	RUN_TEST(testStats);
+	RUN_TEST(testOversize);
+	RUN_TEST(testWrappersOutliveDispose);
+	return 0;
+}
@@ -0,0 +1,39 @@
+/**
+ * Appcelerator Titanium Mobile
+ * Copyright (c) 2016 by Appcelerator, Inc. All Rights Reserved.
+ * Licensed under the terms of the Apache Public License
+ * Please see the LICENSE included with this distribution for details.
+ */
+#ifndef TEST_ANDROID_LOG_H
+#define TEST_ANDROID_LOG_H
+
+#include <stdarg.h>
+#include <stdio.h>
+
+// Stands in for the NDK log header, so sources which only log
+// through AndroidUtil.h build on the host. Logs go to stderr.
+
+typedef enum android_LogPriority {
+	ANDROID_LOG_UNKNOWN = 0,
+	ANDROID_LOG_DEFAULT,
+	ANDROID_LOG_VERBOSE,
+	ANDROID_LOG_DEBUG,
+	ANDROID_LOG_INFO,
+	ANDROID_LOG_WARN,
+	ANDROID_LOG_ERROR,
+	ANDROID_LOG_FATAL,
+	ANDROID_LOG_SILENT
+} android_LogPriority;
+
+static inline int __android_log_print(int /* prio */, const char *tag, const char *fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	fprintf(stderr, "%s: ", tag);
+	int written = vfprintf(stderr, fmt, args);
+	fputc('\n', stderr);
+	va_end(args);
+	return written;
+}
+
+#endif
@@ -70,6 +70,15 @@ public class KrollProxy implements Handler.Callback, KrollProxySupport, OnLifecy
 	protected static final String PROPERTY_HAS_JAVA_LISTENER = "_hasJavaListener";
 
 	protected static AtomicInteger proxyCounter = new AtomicInteger();
+
+	// High frequency events which are coalesced while they wait for the runtime thread.
+	private static final HashMap<String, Integer> eventCoalescing = new HashMap<String, Integer>();
+	static {
+		eventCoalescing.put(TiC.EVENT_SCROLL, KrollRuntime.EVENT_COALESCE_LATEST);
+		eventCoalescing.put(TiC.EVENT_LOCATION, KrollRuntime.EVENT_COALESCE_LATEST);
+		eventCoalescing.put(TiC.EVENT_HEADING, KrollRuntime.EVENT_COALESCE_LATEST);
+		eventCoalescing.put(TiC.EVENT_TOUCH_MOVE, KrollRuntime.EVENT_COALESCE_ACCUMULATE);
+	}
 	protected AtomicInteger listenerIdGenerator;
 
 	protected Map<String, HashMap<Integer, KrollEventCallback>> eventListeners;
@@ -87,6 +96,8 @@ public class KrollProxy implements Handler.Callback, KrollProxySupport, OnLifecy
 
 	private KrollDict langConversionTable = null;
 	private boolean bubbleParent = true;
+	// Read by the runtime when it creates the KrollObject of this proxy.
+	private volatile long externalMemorySize = 0;
 
 	public static final String PROXY_ID_PREFIX = "proxy$";
 
@@ -124,6 +135,8 @@ public class KrollProxy implements Handler.Callback, KrollProxySupport, OnLifecy
 		// object
 		krollObject = object;
 		object.setProxySupport(this);
+		object.adjustExternalMemory(externalMemorySize);
+		updateBubbleParent();
 		this.creationUrl = creationUrl;
 
 		// Associate the activity with the proxy.  if the proxy needs activity association delayed until a 
@@ -438,6 +451,33 @@ public class KrollProxy implements Handler.Callback, KrollProxySupport, OnLifecy
 	public void setKrollObject(KrollObject object)
 	{
 		this.krollObject = object;
+		if (object != null) {
+			object.adjustExternalMemory(externalMemorySize);
+			updateBubbleParent();
+		}
+	}
+
+	/**
+	 * Sets the number of bytes this proxy holds outside of the Java and JavaScript heaps,
+	 * such as bitmap pixels or direct buffers. The size is reported to the JavaScript engine
+	 * so large native allocations held by otherwise small JavaScript objects are
+	 * taken into account when scheduling garbage collections.
+	 * @param bytes the current size of the external memory held by this proxy.
+	 * @module.api
+	 */
+	public void setExternalMemorySize(long bytes)
+	{
+		if (bytes < 0) {
+			bytes = 0;
+		}
+
+		long delta = bytes - externalMemorySize;
+		externalMemorySize = bytes;
+
+		// Without a KrollObject the size is reported once it gets created.
+		if (krollObject != null) {
+			krollObject.adjustExternalMemory(delta);
+		}
 	}
 
 	/**
@@ -738,10 +778,38 @@ public class KrollProxy implements Handler.Callback, KrollProxySupport, OnLifecy
 	public void setBubbleParent(Object value)
 	{
 		bubbleParent = TiConvert.toBoolean(value);
+		updateBubbleParent();
+	}
+
+	/**
+	 * Mirrors the parent returned by {@link #getParentForBubbling()} into the JavaScript
+	 * object so bubbled events walk up the hierarchy without going through Java.
+	 * Subclasses call this whenever their parent for bubbling changes.
+	 */
+	protected void updateBubbleParent()
+	{
+		KrollObject object = krollObject;
+		if (object == null) {
+			// Updated once the KrollObject is created.
+			return;
+		}
+
+		KrollProxy parent = bubbleParent ? getParentForBubbling() : null;
+		if (parent == null) {
+			object.setBubbleParent(null, true);
+			return;
+		}
+
+		// Creating the parent's KrollObject here could block on the runtime thread,
+		// without it events bubble through fireEventToParent() instead.
+		KrollObject parentObject = parent.krollObject;
+		object.setBubbleParent(parentObject, parentObject != null);
 	}
 
 	/**
 	 * Fires an event asynchronously via KrollRuntime thread, which can be intercepted on JS side.
+	 * The event goes through the runtime's event queue, it may be delivered before messages
+	 * sent to the KrollRuntime thread after this call, such as a {@link #fireSyncEvent(String, Object)}.
 	 * @param event the event to be fired.
 	 * @param data  the data to be sent.
 	 * @return whether this proxy has an eventListener for this event.
@@ -750,6 +818,10 @@ public class KrollProxy implements Handler.Callback, KrollProxySupport, OnLifecy
 	public boolean fireEvent(String event, Object data)
 	{
 		if (hierarchyHasListener(event)) {
+			if (KrollRuntime.getInstance().postEvent(this, event, data, getEventCoalescing(event))) {
+				return true;
+			}
+
 			Message message = getRuntimeHandler().obtainMessage(MSG_FIRE_EVENT, data);
 			message.getData().putString(PROPERTY_NAME, event);
 			message.sendToTarget();
@@ -759,6 +831,20 @@ public class KrollProxy implements Handler.Callback, KrollProxySupport, OnLifecy
 		return false;
 	}
 
+	/**
+	 * Returns how pending events of the given type are coalesced when JavaScript falls
+	 * behind, one of the KrollRuntime.EVENT_COALESCE_* constants. Proxies firing other
+	 * high frequency events should override this.
+	 * @param event the event type.
+	 * @return the coalescing policy of the event.
+	 * @module.api
+	 */
+	public int getEventCoalescing(String event)
+	{
+		Integer coalescing = eventCoalescing.get(event);
+		return (coalescing == null) ? KrollRuntime.EVENT_COALESCE_NONE : coalescing;
+	}
+
 	/**
 	 * Send an event to the view who is next to receive the event.
 	 *
@@ -68,6 +68,9 @@ public abstract class TiApplication extends Application implements KrollApplicat
 	private static final String SYSTEM_UNIT = "system";
 	private static final String TAG = "TiApplication";
 	private static final String PROPERTY_THREAD_STACK_SIZE = "ti.android.threadstacksize";
+	private static final String PROPERTY_MAX_YOUNG_SPACE_SIZE = "ti.android.maxyoungspacesize";
+	private static final String PROPERTY_MAX_OLD_SPACE_SIZE = "ti.android.maxoldspacesize";
+	private static final String PROPERTY_PROFILING = "ti.android.profiling";
 	private static final String PROPERTY_COMPILE_JS = "ti.android.compilejs";
 	private static final String PROPERTY_ENABLE_COVERAGE = "ti.android.enablecoverage";
 	private static final String PROPERTY_DEFAULT_UNIT = "ti.ui.defaultunit";
@@ -83,6 +86,7 @@ public abstract class TiApplication extends Application implements KrollApplicat
 	public static final String APPLICATION_PREFERENCES_NAME = "titanium";
 	public static final String PROPERTY_FASTDEV = "ti.android.fastdev";
 	public static final int TRIM_MEMORY_RUNNING_LOW = 10; // Application.TRIM_MEMORY_RUNNING_LOW for API 16+
+	public static final int TRIM_MEMORY_COMPLETE = 80; // Application.TRIM_MEMORY_COMPLETE for API 14+
 
 	// Whether or not using legacy window. This is set in the application's tiapp.xml with the
 	// "ti.android.useLegacyWindow" property.
@@ -396,6 +400,7 @@ public abstract class TiApplication extends Application implements KrollApplicat
 		// Release all the cached images
 		TiBlobLruCache.getInstance().evictAll();
 		TiImageLruCache.getInstance().evictAll();
+		KrollRuntime.notifyLowMemory(TRIM_MEMORY_COMPLETE);
 		super.onLowMemory();
 	}
 
@@ -407,6 +412,11 @@ public abstract class TiApplication extends Application implements KrollApplicat
 			// Release all the cached images
 			TiBlobLruCache.getInstance().evictAll();
 			TiImageLruCache.getInstance().evictAll();
+
+			// Hiding the UI is not memory pressure, the runtime keeps its caches.
+			if (level != TRIM_MEMORY_UI_HIDDEN) {
+				KrollRuntime.notifyLowMemory(level);
+			}
 		}
 		super.onTrimMemory(level);
 	}
@@ -717,6 +727,32 @@ public abstract class TiApplication extends Application implements KrollApplicat
 		return getAppProperties().getInt(PROPERTY_THREAD_STACK_SIZE, DEFAULT_THREAD_STACK_SIZE);
 	}
 
+	/**
+	 * @return the maximum size of the young generation of the JavaScript heap in megabytes,
+	 * or 0 to use the default of the runtime.
+	 */
+	public int getMaxYoungSpaceSize()
+	{
+		return getAppProperties().getInt(PROPERTY_MAX_YOUNG_SPACE_SIZE, 0);
+	}
+
+	/**
+	 * @return the maximum size of the old generation of the JavaScript heap in megabytes,
+	 * or 0 to use the default of the runtime.
+	 */
+	public int getMaxOldSpaceSize()
+	{
+		return getAppProperties().getInt(PROPERTY_MAX_OLD_SPACE_SIZE, 0);
+	}
+
+	/**
+	 * @return whether heap snapshots and allocation tracking are available in production builds.
+	 */
+	public boolean isProfilingEnabled()
+	{
+		return getAppProperties().getBool(PROPERTY_PROFILING, false);
+	}
+
 	public boolean forceCompileJS()
 	{
 		return getAppProperties().getBool(PROPERTY_COMPILE_JS, false);
@@ -995,7 +995,7 @@ public abstract class TiBaseActivity extends AppCompatActivity
 						KrollDict event = new KrollDict();
 						event.put(TiC.EVENT_PROPERTY_SOURCE, actionBarProxy);
 						if (onHomeIconItemSelected != null) {
-							onHomeIconItemSelected.call(activityProxy.getKrollObject(), new Object[] { event });
+							onHomeIconItemSelected.call(activityProxy.getKrollObject(), event);
 						}
 					}
 				}
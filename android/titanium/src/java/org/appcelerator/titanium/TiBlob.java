@@ -89,6 +89,10 @@ public class TiBlob extends KrollProxy
 		this.image = null;
 		this.width = 0;
 		this.height = 0;
+
+		if (data instanceof byte[]) {
+			setExternalMemorySize(((byte[]) data).length);
+		}
 	}
 
 	/**
@@ -167,6 +171,7 @@ public class TiBlob extends KrollProxy
 		blob.image = image;
 		blob.width = image.getWidth();
 		blob.height = image.getHeight();
+		blob.setExternalMemorySize(data.length + (long) image.getRowBytes() * image.getHeight());
 		return blob;
 	}
 
@@ -578,7 +578,7 @@ public abstract class TiViewProxy extends KrollProxy implements Handler.Callback
 
 		} else {
 			children.add(child);
-			child.parent = new WeakReference<TiViewProxy>(this);
+			child.setParent(this);
 		}
 		//TODO zOrder
 	}
@@ -655,7 +655,7 @@ public abstract class TiViewProxy extends KrollProxy implements Handler.Callback
 		}
 
 		children.add(position, child);
-		child.parent = new WeakReference<TiViewProxy>(this);
+		child.setParent(this);
 
 		if (view != null) {
 			child.setActivity(getActivity());
@@ -670,7 +670,7 @@ public abstract class TiViewProxy extends KrollProxy implements Handler.Callback
 	private void handleAdd(TiViewProxy child)
 	{
 		children.add(child);
-		child.parent = new WeakReference<TiViewProxy>(this);
+		child.setParent(this);
 		if (view != null) {
 			child.setActivity(getActivity());
 			if (this instanceof DecorViewProxy) {
@@ -705,7 +705,7 @@ public abstract class TiViewProxy extends KrollProxy implements Handler.Callback
 			if (children != null) {
 				children.remove(child);
 				if (child.parent != null && child.parent.get() == this) {
-					child.parent = null;
+					child.setParent(null);
 				}
 			}
 		}
@@ -1020,10 +1020,10 @@ public abstract class TiViewProxy extends KrollProxy implements Handler.Callback
 	{
 		if (parent == null) {
 			this.parent = null;
-			return;
+		} else {
+			this.parent = new WeakReference<TiViewProxy>(parent);
 		}
-
-		this.parent = new WeakReference<TiViewProxy>(parent);
+		updateBubbleParent();
 	}
 
 	@Override
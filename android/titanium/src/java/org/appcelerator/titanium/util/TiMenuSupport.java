@@ -40,7 +40,7 @@ public class TiMenuSupport
 				menuProxy = new MenuProxy(menu);
 			}
 			event.put(TiC.EVENT_PROPERTY_MENU, menuProxy);
-			onCreate.call(activityProxy.getKrollObject(), new Object[] { event });
+			onCreate.call(activityProxy.getKrollObject(), event);
 		}
 		// If a callback exists then return true.
 		// There is no need for the Ti Developer to support both methods.
@@ -82,7 +82,7 @@ public class TiMenuSupport
 				menuProxy = new MenuProxy(menu);
 			}
 			event.put(TiC.EVENT_PROPERTY_MENU, menuProxy);
-			onPrepare.call(activityProxy.getKrollObject(), new Object[] { event });
+			onPrepare.call(activityProxy.getKrollObject(), event);
 		}
 		prepared = true;
 		return prepared;
@@ -7,35 +7,91 @@
 
 package org.appcelerator.titanium.util;
 
+import java.io.FileInputStream;
+import java.io.FileOutputStream;
 import java.io.IOException;
 import java.io.InputStream;
 import java.io.OutputStream;
+import java.nio.ByteBuffer;
 
 import ti.modules.titanium.BufferProxy;
 
+/**
+ * Reads and writes streams directly from and to the native buffer of a BufferProxy.
+ * File streams go through their channel without an intermediate copy, other streams
+ * through a small per-thread scratch array.
+ */
 public class TiStreamHelper
 {
+	private static final int SCRATCH_SIZE = 8 * 1024;
+
+	private static final ThreadLocal<byte[]> scratch = new ThreadLocal<byte[]>() {
+		@Override
+		protected byte[] initialValue()
+		{
+			return new byte[SCRATCH_SIZE];
+		}
+	};
 
 	public static int read(InputStream inputStream, BufferProxy bufferProxy, int offset, int length) throws IOException
 	{
-		byte[] buffer = bufferProxy.getBuffer();
+		ByteBuffer buffer = bufferProxy.getByteBuffer().duplicate();
+
+		if ((offset + length) > buffer.capacity()) {
+			length = buffer.capacity() - offset;
+		}
+
+		if (offset < 0 || length < 0) {
+			throw new IndexOutOfBoundsException();
+		}
+
+		buffer.position(offset);
+		buffer.limit(offset + length);
 
-		if ((offset + length) > buffer.length) {
-			length = buffer.length - offset;
+		if (inputStream instanceof FileInputStream) {
+			return ((FileInputStream) inputStream).getChannel().read(buffer);
 		}
 
-		return inputStream.read(buffer, offset, length);
+		// A single read, which may return fewer bytes than asked for.
+		byte[] chunk = scratch.get();
+		int bytesRead = inputStream.read(chunk, 0, Math.min(chunk.length, length));
+		if (bytesRead > 0) {
+			buffer.put(chunk, 0, bytesRead);
+		}
+
+		return bytesRead;
 	}
 
 	public static int write(OutputStream outputStream, BufferProxy bufferProxy, int offset, int length) throws IOException
 	{
-		byte[] buffer = bufferProxy.getBuffer();
+		ByteBuffer buffer = bufferProxy.getByteBuffer().duplicate();
+
+		if ((offset + length) > buffer.capacity()) {
+			length = buffer.capacity() - offset;
+		}
 
-		if ((offset + length) > buffer.length) {
-			length = buffer.length - offset;
+		if (offset < 0 || length < 0) {
+			throw new IndexOutOfBoundsException();
 		}
 
-		outputStream.write(buffer, offset, length);
+		buffer.position(offset);
+		buffer.limit(offset + length);
+
+		if (outputStream instanceof FileOutputStream) {
+			FileOutputStream fileStream = (FileOutputStream) outputStream;
+			while (buffer.hasRemaining()) {
+				fileStream.getChannel().write(buffer);
+			}
+			fileStream.flush();
+			return length;
+		}
+
+		byte[] chunk = scratch.get();
+		while (buffer.hasRemaining()) {
+			int count = Math.min(chunk.length, buffer.remaining());
+			buffer.get(chunk, 0, count);
+			outputStream.write(chunk, 0, count);
+		}
 		outputStream.flush();
 
 		return length;
@@ -7,7 +7,7 @@
 package ti.modules.titanium;
 
 import java.io.UnsupportedEncodingException;
-import java.util.Arrays;
+import java.nio.ByteBuffer;
 
 import org.appcelerator.kroll.KrollDict;
 import org.appcelerator.kroll.KrollModule;
@@ -21,7 +21,9 @@ import org.appcelerator.titanium.util.TiConvert;
 import ti.modules.titanium.codec.CodecModule;
 
 /**
- * A proxy that wraps a primitive byte array buffer
+ * A proxy that wraps a primitive byte buffer. The bytes are stored in a direct
+ * (native) ByteBuffer which the JavaScript runtime shares with Java, so indexed
+ * reads and writes from JavaScript do not cross into Java.
  */
 @Kroll.proxy(creatableInModule=TitaniumModule.class, propertyAccessors = {
 	TiC.PROPERTY_BYTE_ORDER,
@@ -32,7 +34,10 @@ public class BufferProxy extends KrollProxy
 {
 	private static final String TAG = "BufferProxy";
 
-	private byte[] buffer;
+	private ByteBuffer buffer;
+
+	// The buffer last shared with the JavaScript object.
+	private ByteBuffer exportedBuffer;
 
 	public BufferProxy()
 	{
@@ -41,12 +46,16 @@ public class BufferProxy extends KrollProxy
 
 	public BufferProxy(int bufferSize)
 	{
-		buffer = new byte[bufferSize];
+		buffer = allocate(bufferSize);
+		setExternalMemorySize(bufferSize);
 	}
 
 	public BufferProxy(byte[] existingBuffer)
 	{
-		buffer = existingBuffer;
+		buffer = allocate(existingBuffer.length);
+		buffer.put(existingBuffer);
+		buffer.clear();
+		setExternalMemorySize(existingBuffer.length);
 	}
 
 	@Override
@@ -54,7 +63,7 @@ public class BufferProxy extends KrollProxy
 	{
 		// If no arguments are provided in create, allocate an empty buffer.
 		if (args.length == 0) {
-			buffer = new byte[0];
+			setBuffer(allocate(0));
 		} else {
 			super.handleCreationArgs(createdInModule, args);
 		}
@@ -77,7 +86,7 @@ public class BufferProxy extends KrollProxy
 			setProperty(TiC.PROPERTY_BYTE_ORDER, CodecModule.getByteOrder(null));
 		}
 
-		buffer = new byte[length];
+		setBuffer(allocate(length));
 		Object value = dict.get(TiC.PROPERTY_VALUE);
 		if (value instanceof Number) {
 			encodeNumber((Number) value, dict);
@@ -93,8 +102,8 @@ public class BufferProxy extends KrollProxy
 			throw new IllegalArgumentException("data is a Number, but no type was given");
 		}
 
-		if (buffer.length == 0) {
-			buffer = new byte[CodecModule.getWidth(type)];
+		if (buffer.capacity() == 0) {
+			setBuffer(allocate(CodecModule.getWidth(type)));
 		}
 
 		int byteOrder = CodecModule.getByteOrder(dict.get(TiC.PROPERTY_BYTE_ORDER));
@@ -111,11 +120,11 @@ public class BufferProxy extends KrollProxy
 		String charset = CodecModule.getCharset(type);
 		try {
 			byte bytes[] = value.getBytes(charset);
-			if (buffer.length == 0) {
-				buffer = bytes;
-			} else {
-				System.arraycopy(bytes, 0, buffer, 0, bytes.length);
+			if (buffer.capacity() == 0) {
+				setBuffer(allocate(bytes.length));
 			}
+			ByteBuffer dest = buffer.duplicate();
+			dest.put(bytes);
 		} catch (UnsupportedEncodingException e) {
 			Log.w(TAG, e.getMessage(), e);
 			throw new IllegalArgumentException("Unsupported Encoding: " + charset);
@@ -123,10 +132,41 @@ public class BufferProxy extends KrollProxy
 	}
 
 	/**
-	 * @return The native buffer for this proxy
+	 * The bytes of this proxy are now held in a native buffer that has no backing array,
+	 * so this returns a copy: changes made to the returned array are not reflected in this buffer.
+	 * @return A copy of the native buffer for this proxy
+	 * @deprecated Use {@link #toByteArray()} to copy the bytes, or {@link #getByteBuffer()}
+	 * to read and modify the buffer in place.
 	 * @module.api
 	 */
+	@Deprecated
 	public byte[] getBuffer()
+	{
+		return toByteArray();
+	}
+
+	/**
+	 * Returns a copy of the bytes in this buffer. Use {@link #getByteBuffer()} or
+	 * {@link #write(int, byte[], int, int)} to modify the buffer contents.
+	 * @return A new array with the contents of this buffer
+	 * @module.api
+	 */
+	public byte[] toByteArray()
+	{
+		byte[] bytes = new byte[buffer.capacity()];
+		buffer.duplicate().get(bytes);
+		return bytes;
+	}
+
+	/**
+	 * The returned buffer shares its memory with the JavaScript object, so writes
+	 * are visible from JavaScript without copying. The buffer is replaced whenever
+	 * this proxy is resized, so do not hold on to it across calls that change the length.
+	 * Always use absolute get/put or a duplicate() since the position is shared.
+	 * @return The direct ByteBuffer backing this proxy
+	 * @module.api
+	 */
+	public ByteBuffer getByteBuffer()
 	{
 		return buffer;
 	}
@@ -134,38 +174,77 @@ public class BufferProxy extends KrollProxy
 	@Override
 	public Object getIndexedProperty(int index)
 	{
-		return buffer[index] & 0xFF;
+		// Only reached until the JavaScript object has been given direct
+		// access to the buffer memory.
+		exportBuffer();
+		return buffer.get(index) & 0xFF;
 	}
 
 	@Override
 	public void setIndexedProperty(int index, Object value)
 	{
+		exportBuffer();
 		if (value instanceof Number) {
-			buffer[index] = ((Number)value).byteValue();
+			buffer.put(index, ((Number)value).byteValue());
 		} else {
 			super.setIndexedProperty(index, value);
 		}
 	}
 
-	protected byte[] copyOf(byte[] array, int newLength)
+	protected static ByteBuffer allocate(int length)
+	{
+		return ByteBuffer.allocateDirect(length);
+	}
+
+	protected void setBuffer(ByteBuffer newBuffer)
 	{
-		byte newArray[] = new byte[newLength];
-		int length = newLength;
-		if (length > array.length) {
-			length = array.length;
+		buffer = newBuffer;
+		setExternalMemorySize(newBuffer.capacity());
+		if (krollObject != null) {
+			exportBuffer();
 		}
-		System.arraycopy(array, 0, newArray, 0, length);
-		return newArray;
 	}
 
-	protected byte[] copyOfRange(byte[] array, int from, int to)
+	// Share the current buffer memory with the JavaScript object
+	// so indexed access is handled entirely inside V8.
+	protected void exportBuffer()
 	{
-		int length = to - from;
-		byte newArray[] = new byte[length];
-		System.arraycopy(array, from, newArray, 0, length);
+		if (exportedBuffer == buffer || krollObject == null) {
+			return;
+		}
+		exportedBuffer = buffer;
+		krollObject.setExternalArrayData(buffer);
+	}
+
+	protected ByteBuffer copyOf(ByteBuffer array, int newLength)
+	{
+		return copyOfRange(array, 0, newLength);
+	}
+
+	// Copies the range [from, to) into a new buffer. Bytes past the end
+	// of the source buffer are zero filled.
+	protected ByteBuffer copyOfRange(ByteBuffer array, int from, int to)
+	{
+		ByteBuffer newArray = allocate(to - from);
+		int end = Math.min(to, array.capacity());
+		if (end > from) {
+			ByteBuffer src = array.duplicate();
+			src.limit(end).position(from);
+			newArray.put(src);
+			newArray.clear();
+		}
 		return newArray;
 	}
 
+	protected static void copyBytes(ByteBuffer src, int srcOffset, ByteBuffer dest, int destOffset, int length)
+	{
+		ByteBuffer source = src.duplicate();
+		source.limit(srcOffset + length).position(srcOffset);
+		ByteBuffer destination = dest.duplicate();
+		destination.position(destOffset);
+		destination.put(source);
+	}
+
 	protected void validateOffsetAndLength(int offset, int length, int bufferLength)
 	{
 		if (length > offset + bufferLength) {
@@ -184,11 +263,25 @@ public class BufferProxy extends KrollProxy
 	 */
 	public int write(int position, byte[] sourceBuffer, int sourceOffset, int sourceLength)
 	{
-		if ((position + sourceLength) > buffer.length) {
-			buffer = copyOf(buffer, (position + sourceLength));
+		return write(position, ByteBuffer.wrap(sourceBuffer), sourceOffset, sourceLength);
+	}
+
+	/**
+	 * Writes data from sourceBuffer into this.
+	 * @param position the offset position of this buffer.
+	 * @param sourceBuffer the source buffer to write from.
+	 * @param sourceOffset the offset position of the sourceBuffer.
+	 * @param sourceLength the length of the sourceBuffer.
+	 * @return number of bytes written, -1 if no data is available.
+	 * @module.api
+	 */
+	public int write(int position, ByteBuffer sourceBuffer, int sourceOffset, int sourceLength)
+	{
+		if ((position + sourceLength) > buffer.capacity()) {
+			setBuffer(copyOf(buffer, (position + sourceLength)));
 		}
 
-		System.arraycopy(sourceBuffer, sourceOffset, buffer, position, sourceLength);
+		copyBytes(sourceBuffer, sourceOffset, buffer, position, sourceLength);
 
 		return sourceLength;
 	}
@@ -196,24 +289,25 @@ public class BufferProxy extends KrollProxy
 	@Kroll.method
 	public int append(Object[] args)
 	{
-		int destLength = buffer.length;
+		int destLength = buffer.capacity();
 		BufferProxy src = (BufferProxy) args[0];
-		byte[] sourceBuffer = src.getBuffer();
+		ByteBuffer sourceBuffer = src.getByteBuffer();
 
 		int offset = 0;
 		if (args.length > 1 && args[1] != null) {
 			offset = TiConvert.toInt(args[1]);
 		}
 
-		int sourceLength = sourceBuffer.length;
+		int sourceLength = sourceBuffer.capacity();
 		if (args.length > 2 && args[2] != null) {
 			sourceLength = TiConvert.toInt(args[2]);
 		}
 
-		validateOffsetAndLength(offset, sourceLength, sourceBuffer.length);
+		validateOffsetAndLength(offset, sourceLength, sourceBuffer.capacity());
 
-		buffer = copyOf(buffer, (destLength + sourceLength));
-		System.arraycopy(sourceBuffer, offset, buffer, destLength, sourceLength);
+		ByteBuffer newBuffer = copyOf(buffer, (destLength + sourceLength));
+		copyBytes(sourceBuffer, offset, newBuffer, destLength, sourceLength);
+		setBuffer(newBuffer);
 		return sourceLength;
 	}
 
@@ -224,7 +318,7 @@ public class BufferProxy extends KrollProxy
 			throw new IllegalArgumentException("At least 2 arguments required for insert: src, offset");
 		}
 		BufferProxy sourceBufferProxy = (BufferProxy) args[0];
-		byte[] sourceBuffer = sourceBufferProxy.getBuffer();
+		ByteBuffer sourceBuffer = sourceBufferProxy.getByteBuffer();
 		int offset = TiConvert.toInt(args[1]);
 
 		int sourceOffset = 0;
@@ -232,20 +326,19 @@ public class BufferProxy extends KrollProxy
 			sourceOffset = TiConvert.toInt(args[2]);
 		}
 
-		int sourceLength = sourceBuffer.length;
+		int sourceLength = sourceBuffer.capacity();
 		if (args.length > 3 && args[3] != null) {
 			sourceLength = TiConvert.toInt(args[3]);
 		}
 
-		validateOffsetAndLength(sourceOffset, sourceLength, sourceBuffer.length);
+		validateOffsetAndLength(sourceOffset, sourceLength, sourceBuffer.capacity());
 
-		byte[] preInsertBuffer = copyOf(buffer, offset);
-		byte[] postInsertBuffer = copyOfRange(buffer, offset, buffer.length);
-
-		buffer = new byte[(preInsertBuffer.length + sourceLength + postInsertBuffer.length)];
-		System.arraycopy(preInsertBuffer, 0, buffer, 0, preInsertBuffer.length);
-		System.arraycopy(sourceBuffer, sourceOffset, buffer, preInsertBuffer.length, sourceLength);
-		System.arraycopy(postInsertBuffer, 0, buffer, (preInsertBuffer.length + sourceLength), postInsertBuffer.length);
+		int length = buffer.capacity();
+		ByteBuffer newBuffer = allocate(length + sourceLength);
+		copyBytes(buffer, 0, newBuffer, 0, offset);
+		copyBytes(sourceBuffer, sourceOffset, newBuffer, offset, sourceLength);
+		copyBytes(buffer, offset, newBuffer, (offset + sourceLength), (length - offset));
+		setBuffer(newBuffer);
 
 		return sourceLength;
 	}
@@ -258,7 +351,7 @@ public class BufferProxy extends KrollProxy
 		}
 
 		BufferProxy sourceBufferProxy = (BufferProxy) args[0];
-		byte[] sourceBuffer = sourceBufferProxy.getBuffer();
+		ByteBuffer sourceBuffer = sourceBufferProxy.getByteBuffer();
 
 		int offset = 0;
 		if (args.length > 1 && args[1] != null) {
@@ -270,14 +363,14 @@ public class BufferProxy extends KrollProxy
 			sourceOffset = TiConvert.toInt(args[2]);
 		}
 
-		int sourceLength = sourceBuffer.length;
+		int sourceLength = sourceBuffer.capacity();
 		if (args.length > 3 && args[3] != null) {
 			sourceLength = TiConvert.toInt(args[3]);
 		}
 
-		validateOffsetAndLength(sourceOffset, sourceLength, sourceBuffer.length);
+		validateOffsetAndLength(sourceOffset, sourceLength, sourceBuffer.capacity());
 
-		System.arraycopy(sourceBuffer, sourceOffset, buffer, offset, sourceLength);
+		copyBytes(sourceBuffer, sourceOffset, buffer, offset, sourceLength);
 		return sourceLength;
 	}
 
@@ -289,14 +382,16 @@ public class BufferProxy extends KrollProxy
 			offset = TiConvert.toInt(args[0]);
 		}
 
-		int length = buffer.length;
+		int length = buffer.capacity();
 		if (args.length > 1 && args[1] != null) {
 			length = TiConvert.toInt(args[1]);
 		}
 
-		validateOffsetAndLength(offset, length, buffer.length);
+		validateOffsetAndLength(offset, length, buffer.capacity());
 
-		return new BufferProxy(copyOfRange(buffer, offset, offset+length));
+		BufferProxy clone = new BufferProxy();
+		clone.setBuffer(copyOfRange(buffer, offset, offset+length));
+		return clone;
 	}
 
 	@Kroll.method
@@ -312,38 +407,45 @@ public class BufferProxy extends KrollProxy
 			offset = TiConvert.toInt(args[1]);
 		}
 
-		int length = buffer.length;
+		int length = buffer.capacity();
 		if (args.length > 2 && args[2] != null) {
 			length = TiConvert.toInt(args[2]);
 		}
 
-		validateOffsetAndLength(offset, length, buffer.length);
+		validateOffsetAndLength(offset, length, buffer.capacity());
+
+		fill(offset, (offset + length), (byte)fillByte);
+	}
 
-		Arrays.fill(buffer, offset, (offset + length), (byte)fillByte);
+	protected void fill(int from, int to, byte value)
+	{
+		for (int i = from; i < to; i++) {
+			buffer.put(i, value);
+		}
 	}
 
 	@Kroll.method
 	public void clear()
 	{
-		Arrays.fill(buffer, (byte)0);
+		fill(0, buffer.capacity(), (byte)0);
 	}
 
 	@Kroll.method
 	public void release()
 	{
-		buffer = new byte[0];
+		setBuffer(allocate(0));
 	}
 
 	@Kroll.method
 	public String toString()
 	{
-		return new String(buffer);
+		return new String(toByteArray());
 	}
 
 	@Kroll.method
 	public TiBlob toBlob()
 	{
-		return TiBlob.blobFromData(buffer);
+		return TiBlob.blobFromData(toByteArray());
 	}
 
 	/**
@@ -353,7 +455,7 @@ public class BufferProxy extends KrollProxy
 	@Kroll.getProperty @Kroll.method
 	public int getLength()
 	{
-		return buffer.length;
+		return buffer.capacity();
 	}
 
 	/**
@@ -370,7 +472,7 @@ public class BufferProxy extends KrollProxy
 
 	public void resize(int length)
 	{
-		buffer = copyOf(buffer, length);
+		setBuffer(copyOf(buffer, length));
 	}
 
 	@Override
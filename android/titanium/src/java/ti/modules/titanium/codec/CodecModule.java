@@ -7,6 +7,7 @@
 package ti.modules.titanium.codec;
 
 import java.io.UnsupportedEncodingException;
+import java.nio.ByteBuffer;
 import java.nio.ByteOrder;
 
 import org.appcelerator.kroll.KrollDict;
@@ -64,21 +65,25 @@ public class CodecModule extends KrollModule
 			position = TiConvert.toInt(args, TiC.PROPERTY_POSITION);
 		}
 
-		byte buffer[] = dest.getBuffer();
-		return encodeNumber(src, type, buffer, position, byteOrder);
+		return encodeNumber(src, type, dest.getByteBuffer(), position, byteOrder);
 	}
 
 	public static int encodeNumber(Number src, String type, byte dest[], int position, int byteOrder)
+	{
+		return encodeNumber(src, type, ByteBuffer.wrap(dest), position, byteOrder);
+	}
+
+	public static int encodeNumber(Number src, String type, ByteBuffer dest, int position, int byteOrder)
 	{
 		long l = src.longValue();
 		if (type.equals(TYPE_BYTE)) {
-			dest[position] = (byte)(l & 0xFF);
+			dest.put(position, (byte)(l & 0xFF));
 			return position+1;
 		} else if (type.equals(TYPE_SHORT)) {
 			int bits = byteOrder == BIG_ENDIAN ? 8 : 0;
 			int step = byteOrder == BIG_ENDIAN ? -8 : 8;
 			for (int i = position; i < position+2; i++, bits += step) {
-				dest[i] = (byte)((l >>> bits) & 0xFF);
+				dest.put(i, (byte)((l >>> bits) & 0xFF));
 			}
 			return position+2;
 		} else if (type.equals(TYPE_INT) || type.equals(TYPE_FLOAT)) {
@@ -88,7 +93,7 @@ public class CodecModule extends KrollModule
 			int bits = byteOrder == BIG_ENDIAN ? 24 : 0;
 			int step = byteOrder == BIG_ENDIAN ? -8 : 8;
 			for (int j = position; j < position+4; j++, bits += step) {
-				dest[j] = (byte)((l >>> bits) & 0xFF);
+				dest.put(j, (byte)((l >>> bits) & 0xFF));
 			}
 			return position+4;
 		} else if (type.equals(TYPE_LONG) || type.equals(TYPE_DOUBLE)) {
@@ -98,7 +103,7 @@ public class CodecModule extends KrollModule
 			int bits = byteOrder == BIG_ENDIAN ? 56 : 0;
 			int step = byteOrder == BIG_ENDIAN ? -8 : 8;
 			for (int i = position; i < position+8; i++, bits += step) {
-				dest[i] = (byte)((l >>> bits) & 0xFF);
+				dest.put(i, (byte)((l >>> bits) & 0xFF));
 			}
 			return position+8;
 		}
@@ -124,13 +129,13 @@ public class CodecModule extends KrollModule
 			position = TiConvert.toInt(args, TiC.PROPERTY_POSITION);
 		}
 
-		byte src[] = buffer.getBuffer();
+		ByteBuffer src = buffer.getByteBuffer();
 		if (type.equals(TYPE_BYTE)) {
-			return src[position];
+			return src.get(position);
 		}
 		else if (type.equals(TYPE_SHORT)) {
-			short s1 = (short) (src[position] & 0xFF);
-			short s2 = (short) (src[position + 1] & 0xFF);
+			short s1 = (short) (src.get(position) & 0xFF);
+			short s2 = (short) (src.get(position + 1) & 0xFF);
 			switch (byteOrder) {
 				case BIG_ENDIAN:
 					return ((s1 << 8) + s2);
@@ -142,7 +147,7 @@ public class CodecModule extends KrollModule
 			int shiftBits = byteOrder == BIG_ENDIAN ? 24 : 0;
 			int step = byteOrder == BIG_ENDIAN ? -8 : 8;
 			for (int i = 0; i < 4; i++, shiftBits += step) {
-				int part = (int) (src[position + i] & 0xFF);
+				int part = (int) (src.get(position + i) & 0xFF);
 				bits += (part << shiftBits);
 			}
 			if (type.equals(TYPE_FLOAT)) {
@@ -154,7 +159,7 @@ public class CodecModule extends KrollModule
 			int shiftBits = byteOrder == BIG_ENDIAN ? 56 : 0;
 			int step = byteOrder == BIG_ENDIAN ? -8 : 8;
 			for (int i = 0; i < 8; i++, shiftBits += step) {
-				long part = (long) (src[position + i] & 0xFF);
+				long part = (long) (src.get(position + i) & 0xFF);
 				bits += (part << shiftBits);
 			}
 			if (type.equals(TYPE_DOUBLE)) {
@@ -192,7 +197,7 @@ public class CodecModule extends KrollModule
 		}
 
 		String charset = validateCharset(args);
-		byte destBuffer[] = dest.getBuffer();
+		ByteBuffer destBuffer = dest.getByteBuffer().duplicate();
 		validatePositionAndLength(srcPosition, srcLength, src.length());
 
 		if (srcPosition != 0 || srcLength != src.length()) {
@@ -201,7 +206,8 @@ public class CodecModule extends KrollModule
 
 		try {
 			byte encoded[] = src.getBytes(charset);
-			System.arraycopy(encoded, 0, destBuffer, destPosition, encoded.length);
+			destBuffer.position(destPosition);
+			destBuffer.put(encoded);
 
 			return destPosition + encoded.length;
 		} catch (UnsupportedEncodingException e) {
@@ -218,22 +224,26 @@ public class CodecModule extends KrollModule
 		}
 
 		BufferProxy src = (BufferProxy) args.get(TiC.PROPERTY_SOURCE);
-		byte buffer[] = src.getBuffer();
+		ByteBuffer buffer = src.getByteBuffer().duplicate();
 
 		int position = 0;
 		if (args.containsKey(TiC.PROPERTY_POSITION)) {
 			position = TiConvert.toInt(args, TiC.PROPERTY_POSITION);
 		}
-		int length = buffer.length;
+		int length = buffer.capacity();
 		if (args.containsKey(TiC.PROPERTY_LENGTH)) {
 			length = TiConvert.toInt(args, TiC.PROPERTY_LENGTH);
 		}
 
-		validatePositionAndLength(position, length, buffer.length);
+		validatePositionAndLength(position, length, buffer.capacity());
 		String charset = validateCharset(args);
 
+		byte bytes[] = new byte[length];
+		buffer.position(position);
+		buffer.get(bytes);
+
 		try {
-			return new String(buffer, position, length, charset);
+			return new String(bytes, charset);
 		} catch (UnsupportedEncodingException e) {
 			Log.w(TAG, e.getMessage(), e);
 			throw new IllegalArgumentException("Unsupported Encoding: " + charset);
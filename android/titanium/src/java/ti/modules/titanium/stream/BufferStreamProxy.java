@@ -6,14 +6,13 @@
  */
 package ti.modules.titanium.stream;
 
-import java.io.ByteArrayInputStream;
 import java.io.IOException;
+import java.nio.ByteBuffer;
 
 import org.appcelerator.kroll.KrollProxy;
 import org.appcelerator.kroll.annotations.Kroll;
 import org.appcelerator.kroll.common.Log;
 import org.appcelerator.titanium.io.TiStream;
-import org.appcelerator.titanium.util.TiStreamHelper;
 
 import ti.modules.titanium.BufferProxy;
 
@@ -102,22 +101,29 @@ public class BufferStreamProxy extends KrollProxy implements TiStream
 			throw new IllegalArgumentException("Invalid number of arguments");
 		}
 
-		ByteArrayInputStream bufferInputStream = new ByteArrayInputStream(buffer.getBuffer(), position, (buffer.getLength() - position));
-		int bytesRead;
-
-		try {
-			bytesRead = TiStreamHelper.read(bufferInputStream, bufferProxy, offset, length);
+		// Copies between the native buffers without an intermediate array.
+		ByteBuffer destination = bufferProxy.getByteBuffer().duplicate();
+		if ((offset + length) > destination.capacity()) {
+			length = destination.capacity() - offset;
+		}
+		if (offset < 0 || length < 0) {
+			throw new IndexOutOfBoundsException();
+		}
 
-			if (bytesRead > -1) {
-				position += bytesRead;
-			}
+		int available = buffer.getLength() - position;
+		if (available <= 0) {
+			return -1;
+		}
 
-			return bytesRead;
+		int bytesRead = Math.min(length, available);
+		ByteBuffer source = buffer.getByteBuffer().duplicate();
+		source.position(position);
+		source.limit(position + bytesRead);
+		destination.position(offset);
+		destination.put(source);
 
-		} catch (IOException e) {
-			Log.e(TAG, "Unable to read from buffer stream, IO error", e);
-			throw new IOException("Unable to read from buffer stream, IO error");
-		}
+		position += bytesRead;
+		return bytesRead;
 	}
 
 	@Kroll.method
@@ -172,7 +178,7 @@ public class BufferStreamProxy extends KrollProxy implements TiStream
 			throw new IllegalArgumentException("Invalid number of arguments");
 		}
 
-		int bytesWritten = buffer.write(position, bufferProxy.getBuffer(), offset, length);
+		int bytesWritten = buffer.write(position, bufferProxy.getByteBuffer(), offset, length);
 		position += bytesWritten;
 
 		return bytesWritten;